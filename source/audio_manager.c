@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_AU
 #include "neurottic.h"
 
 static Mix_Music *current_chunk = NULL;
@@ -32,6 +33,37 @@ static const SDL_AudioSpec mixer_spec = {
 	44100
 };
 
+/*
+ *
+ * console
+ *
+ */
+
+static int CMD_PlayMusic(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		Console_Printf("Usage: playmusic <trackname>");
+		return 0;
+	}
+
+	if (AU_PlayMusic(argv[1], SDL_FALSE) == 0)
+		Console_Printf("Playing %s", argv[1]);
+
+	return 0;
+}
+
+static int CMD_StopMusic(int argc, char **argv)
+{
+	AU_StopMusic();
+	return 0;
+}
+
+static void CVAR_MusicVolume(cvar_t *cvar)
+{
+	AU_SetMusicVolume(cvar->value_float);
+}
+
 int AU_Init(void)
 {
 	/* setup audio device */
@@ -50,6 +82,11 @@ int AU_Init(void)
 		LogWarning("AU_Init(): Failed to setup soundfonts");
 	}
 
+	/* console */
+	Console_RegisterCommand("playmusic", CMD_PlayMusic);
+	Console_RegisterCommand("stopmusic", CMD_StopMusic);
+	Console_RegisterCvar("music_volume", "0.5", CVAR_FLOAT, CVAR_MusicVolume);
+
 	return Log("Initialized audio manager");
 }
 
@@ -0,0 +1,381 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * offscreen render benchmark
+ *
+ * loads the game data, then flies a deterministic camera path through every
+ * used map of a mapset, rendering into the 8-bit screen surface without ever
+ * presenting it. reports timings per map and a hash of every rendered frame,
+ * so that renderer changes can be checked for both speed and output changes.
+ *
+ * with -raycast, only the rays are cast and nothing is drawn. the hash then
+ * covers the number of wall hits of every frame, and the average and largest
+ * number of ray steps per column are reported. -noskip makes rays step
+ * through empty blocks of the map tile by tile. -scale sets r_scale, to
+ * draw the 3D view at a fraction of the screen resolution.
+ *
+ * with -blit, no maps are rendered. instead R_DrawSurface() and
+ * SDL_SoftStretch() draw the same pics at several scales, for the given pic
+ * lumps and a generated weapon-like pic that is mostly transparent.
+ *
+ * usage: neurottic_bench [-rtl <mapset>] [-map <n>] [-frames <n>] [-raycast] [-noskip] [-scale <n>] [-blit [pic ...]]
+ */
+
+#include "neurottic.h"
+
+#define SDL_MAIN_NOIMPL
+#include <SDL3/SDL_main.h>
+
+#define BENCH_WAYPOINTS (8)
+#define BENCH_WAYPOINT_SPACING (97)
+#define BENCH_BLIT_SCALES (3)
+#define BENCH_MAX_PICS (16)
+
+typedef struct bench_result {
+	Uint64 frames;
+	Uint64 ticks;
+	Uint32 hash;
+	Uint64 steps;
+	Uint32 max_column_steps;
+} bench_result_t;
+
+/* fnv-1a over the rendered frame */
+static Uint32 HashSurface(SDL_Surface *surface, Uint32 hash)
+{
+	for (int y = 0; y < surface->h; y++)
+	{
+		Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+
+		for (int x = 0; x < surface->w; x++)
+		{
+			hash ^= row[x];
+			hash *= 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+/* pick open tiles spread through the map, always starting at the player start */
+static int FindWaypoints(int *xs, int *ys, int *angle)
+{
+	Uint16 *walls = MS_GetCurrentMapPlane(0);
+	int num_waypoints = 0;
+	int x, y;
+
+	if (MS_FindPlayerStart(&x, &y, angle) == 0)
+	{
+		xs[num_waypoints] = x;
+		ys[num_waypoints] = y;
+		num_waypoints++;
+	}
+	else
+	{
+		*angle = 0;
+	}
+
+	for (int i = 0; i < 128 * 128 && num_waypoints < BENCH_WAYPOINTS; i += BENCH_WAYPOINT_SPACING)
+	{
+		if (DarkWar_GetWallTexture(walls[i]) != NULL)
+			continue;
+
+		xs[num_waypoints] = i % 128;
+		ys[num_waypoints] = i / 128;
+		num_waypoints++;
+	}
+
+	return num_waypoints;
+}
+
+static int BenchMap(int map, int frames_per_waypoint, SDL_bool raycast, bench_result_t *result)
+{
+	SDL_Surface *screen = R_GetScreenSurface();
+	int xs[BENCH_WAYPOINTS], ys[BENCH_WAYPOINTS];
+	int num_waypoints, angle;
+
+	if (MS_LoadMap(map) != 0)
+		return -1;
+
+	if (R_NewMap() != 0)
+		return -1;
+
+	num_waypoints = FindWaypoints(xs, ys, &angle);
+
+	result->frames = 0;
+	result->ticks = 0;
+	result->hash = 2166136261u;
+	result->steps = 0;
+	result->max_column_steps = 0;
+
+	/* spin around once at every waypoint */
+	for (int w = 0; w < num_waypoints; w++)
+	{
+		R_SetPosition(xs[w] + 0.5f, ys[w] + 0.5f, 0.5f);
+
+		for (int f = 0; f < frames_per_waypoint; f++)
+		{
+			Uint64 start;
+
+			R_SetAngles(0, angle + (360.0f * f) / frames_per_waypoint, 0);
+
+			if (raycast)
+			{
+				ray_stats_t stats;
+
+				start = SDL_GetPerformanceCounter();
+				R_CastRays(&stats);
+				result->ticks += SDL_GetPerformanceCounter() - start;
+				result->frames++;
+
+				result->hash = (result->hash ^ (Uint32)stats.hits) * 16777619u;
+				result->steps += stats.steps;
+				result->max_column_steps = SDL_max(result->max_column_steps, stats.max_column_steps);
+				continue;
+			}
+
+			start = SDL_GetPerformanceCounter();
+			R_Clear(0x00);
+			R_Draw();
+			result->ticks += SDL_GetPerformanceCounter() - start;
+			result->frames++;
+
+			result->hash = HashSurface(screen, result->hash);
+		}
+	}
+
+	return 0;
+}
+
+static void PrintResult(const char *name, bench_result_t *result)
+{
+	double seconds = (double)result->ticks / (double)SDL_GetPerformanceFrequency();
+	double frames = (double)result->frames;
+	int width, height;
+
+	R_GetViewSize(&width, &height);
+
+	if (result->frames == 0 || seconds <= 0)
+		return;
+
+	Log("%-24s %6" SDL_PRIu64 " frames %8.3f ms/frame %8.2f Mcol/s %8.2f Mpix/s hash %08x",
+		name, result->frames, (seconds * 1000.0) / frames,
+		(frames * width) / seconds / 1000000.0,
+		(frames * width * height) / seconds / 1000000.0,
+		result->hash);
+
+	if (result->steps)
+		Log("%-24s %8.2f steps/column %6u max", "", (double)result->steps / (frames * width), result->max_column_steps);
+}
+
+/* a weapon sized pic, opaque in a blob in the bottom middle and keyed elsewhere */
+static SDL_Surface *CreateWeaponPic(void)
+{
+	SDL_Surface *surface = SDL_CreateSurface(128, 96, SDL_PIXELFORMAT_INDEX8);
+	if (!surface)
+		return NULL;
+
+	SDL_SetSurfaceColorKey(surface, SDL_TRUE, 0xFF);
+
+	for (int y = 0; y < surface->h; y++)
+	{
+		Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+
+		for (int x = 0; x < surface->w; x++)
+		{
+			int dx = x - surface->w / 2;
+			int dy = y - surface->h;
+
+			if (dx * dx + dy * dy * 2 < 56 * 56 && ((x ^ y) & 7) != 0)
+				row[x] = (Uint8)((x + y) & 0x7F);
+			else
+				row[x] = 0xFF;
+		}
+	}
+
+	return surface;
+}
+
+/* draw a pic bottom centered at 1x to BENCH_BLIT_SCALES x with both blitters */
+static void BenchBlit(const char *name, SDL_Surface *pic, int frames)
+{
+	SDL_Surface *screen = R_GetScreenSurface();
+	double frequency = (double)SDL_GetPerformanceFrequency();
+
+	for (int scale = 1; scale <= BENCH_BLIT_SCALES; scale++)
+	{
+		SDL_Rect rect;
+		Uint64 start, ticks_draw, ticks_stretch;
+
+		rect.w = pic->w * scale;
+		rect.h = pic->h * scale;
+		rect.x = (screen->w - rect.w) / 2;
+		rect.y = screen->h - rect.h;
+
+		/* SDL_SoftStretch() doesn't clip */
+		if (rect.w > screen->w || rect.h > screen->h)
+			break;
+
+		start = SDL_GetPerformanceCounter();
+		for (int f = 0; f < frames; f++)
+			R_DrawSurface(rect.x, rect.y, rect.w, rect.h, pic);
+		ticks_draw = SDL_GetPerformanceCounter() - start;
+
+		start = SDL_GetPerformanceCounter();
+		for (int f = 0; f < frames; f++)
+			SDL_SoftStretch(pic, NULL, screen, &rect, SDL_SCALEMODE_NEAREST);
+		ticks_stretch = SDL_GetPerformanceCounter() - start;
+
+		Log("%-12s %4dx%-4d %8.2f us R_DrawSurface %8.2f us SDL_SoftStretch",
+			name, rect.w, rect.h,
+			((double)ticks_draw * 1000000.0) / frequency / frames,
+			((double)ticks_stretch * 1000000.0) / frequency / frames);
+	}
+}
+
+static int SDLCALL BenchMain(int argc, char **argv)
+{
+	const char *mapset = NULL;
+	int only_map = -1;
+	int frames_per_waypoint = 64;
+	SDL_bool raycast = SDL_FALSE;
+	SDL_bool noskip = SDL_FALSE;
+	const char *scale = NULL;
+	SDL_bool blit = SDL_FALSE;
+	const char *pics[BENCH_MAX_PICS];
+	int num_pics = 0;
+	int width, height;
+	bench_result_t total = {0, 0, 2166136261u, 0, 0};
+
+	/* parse arguments */
+	for (int i = 1; i < argc; i++)
+	{
+		if (SDL_strcmp(argv[i], "-rtl") == 0 && i + 1 < argc)
+			mapset = argv[++i];
+		else if (SDL_strcmp(argv[i], "-map") == 0 && i + 1 < argc)
+			only_map = SDL_atoi(argv[++i]);
+		else if (SDL_strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+			frames_per_waypoint = SDL_atoi(argv[++i]);
+		else if (SDL_strcmp(argv[i], "-raycast") == 0)
+			raycast = SDL_TRUE;
+		else if (SDL_strcmp(argv[i], "-noskip") == 0)
+			noskip = SDL_TRUE;
+		else if (SDL_strcmp(argv[i], "-scale") == 0 && i + 1 < argc)
+			scale = argv[++i];
+		else if (SDL_strcmp(argv[i], "-blit") == 0)
+		{
+			blit = SDL_TRUE;
+
+			while (i + 1 < argc && argv[i + 1][0] != '-' && num_pics < BENCH_MAX_PICS)
+				pics[num_pics++] = argv[++i];
+		}
+	}
+
+	/* SDL_max() would evaluate argv[++i] twice */
+	frames_per_waypoint = SDL_max(frames_per_waypoint, 1);
+
+	/* never open a visible window or a real audio device */
+	SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+	if (Start() != 0)
+		Die(SDL_GetError());
+
+	if (LoadAssets() != 0)
+		Die(SDL_GetError());
+
+	if (mapset && MS_LoadMapSet(mapset) != 0)
+		Die(SDL_GetError());
+
+	if (noskip)
+		Console_SetCvar(Console_FindCvar("r_skip_blocks"), "0");
+
+	if (scale)
+		Console_SetCvar(Console_FindCvar("r_scale"), scale);
+
+	if (blit)
+	{
+		SDL_Surface *weapon = CreateWeaponPic();
+
+		Log("Drawing pics %d times per scale", frames_per_waypoint * 16);
+
+		for (int i = 0; i < num_pics; i++)
+		{
+			SDL_Surface *pic = LM_CachePic(pics[i]);
+			if (pic)
+				BenchBlit(pics[i], pic, frames_per_waypoint * 16);
+		}
+
+		if (weapon)
+		{
+			BenchBlit("weapon", weapon, frames_per_waypoint * 16);
+			SDL_DestroySurface(weapon);
+		}
+
+		Quit();
+
+		return 0;
+	}
+
+	R_GetViewSize(&width, &height);
+
+	Log("%s %d frames per waypoint at %dx%d", raycast ? "Raycasting" : "Rendering", frames_per_waypoint, width, height);
+
+	for (int map = 0; map < 100; map++)
+	{
+		bench_result_t result;
+		char name[40];
+
+		if (!MS_MapIsUsed(map) || (only_map >= 0 && map != only_map))
+			continue;
+
+		if (BenchMap(map, frames_per_waypoint, raycast, &result) != 0)
+			continue;
+
+		SDL_snprintf(name, sizeof(name), "%02d %s", map, MS_GetMapName(map));
+		PrintResult(name, &result);
+
+		total.frames += result.frames;
+		total.ticks += result.ticks;
+		total.hash = (total.hash ^ result.hash) * 16777619u;
+		total.steps += result.steps;
+		total.max_column_steps = SDL_max(total.max_column_steps, result.max_column_steps);
+	}
+
+	PrintResult("total", &total);
+
+	Quit();
+
+	return 0;
+}
+
+/* the same heap accounting as the game, installed before SDL_RunApp()
+ * allocates anything */
+int main(int argc, char **argv)
+{
+	Perf_TrackHeap();
+
+	return SDL_RunApp(argc, argv, BenchMain, NULL);
+}
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_CON
 #include "neurottic.h"
 
 /*
@@ -32,23 +33,39 @@ SOFTWARE.
 
 #define CON_FONTWIDTH (8)
 #define CON_FONTHEIGHT (8)
-#define CON_NUMLINES (RENDER_HEIGHT / CON_FONTHEIGHT)
 #define CON_LINESIZE (80)
-#define CON_BUFSIZE (4096)
 #define CON_PREFIXSIZE (2)
 
+/* scrollback text size, must be a power of two */
+#ifndef CON_BUFSIZE
+#define CON_BUFSIZE (1024 * 1024)
+#endif
+
+/* max scrollback lines, must be a power of two */
+#define CON_MAXLINES (CON_BUFSIZE / 32)
+
+/* longest single line kept in the scrollback */
+#define CON_MAXLINELEN (CON_BUFSIZE / 4)
+
+/* command buffer size, and longest single command */
+#define CON_CMDBUFSIZE (16384)
+#define CON_CMDLINESIZE (1024)
+
+/* initial registry size, must be a power of two */
+#define CON_MINENTRIES (64)
+
 typedef struct cmd {
 	const char *name;
-	int (*func)(int argc, char **argv);
+	cmd_func_t func;
 } cmd_t;
 
-typedef struct cvar {
-	const char *name;
-	const char *value_default;
-	char *value_string;
-	float value_float;
-	Sint32 value_int;
-} cvar_t;
+/* registry slot, holds either a command or a cvar */
+typedef struct entry {
+	char *name;
+	Uint32 hash;
+	cmd_func_t func;
+	cvar_t *cvar;
+} entry_t;
 
 /*
  *
@@ -57,10 +74,29 @@ typedef struct cvar {
  */
 
 static SDL_bool started = SDL_FALSE;
+static SDL_Mutex *mutex = NULL;
+
+/* command and cvar registry, open addressing hash table */
+static entry_t *entries = NULL;
+static int num_entries = 0;
+static int max_entries = 0;
+
+/* commands waiting to be executed */
+static char cmdbuf[CON_CMDBUFSIZE];
+static int cmdbuf_len = 0;
+static int wait_ticks = 0;
+static int scroll = 0;
+
+/*
+ * scrollback is a ring of text, and a ring of line start offsets into it.
+ * offsets count every byte ever written, so a line is still intact as long
+ * as less than CON_BUFSIZE bytes have been written after its start.
+ */
 static char textbuf[CON_BUFSIZE] = {};
-static char *textbuf_ptr = NULL;
-static char *lines[CON_NUMLINES] = {};
-static int num_lines = 0;
+static Uint64 text_head = 0;
+static Uint64 line_offsets[CON_MAXLINES] = {};
+static Uint64 first_line = 0;
+static Uint64 next_line = 0;
 static char input[CON_LINESIZE] = {};
 static int input_len = 0;
 static int input_cursor = 0;
@@ -71,23 +107,152 @@ static int input_cursor = 0;
  *
  */
 
-static int CMD_PlayMusic(int argc, char **argv)
+static int CMD_Exec(int argc, char **argv)
 {
+	SDL_IOStream *io;
+	char *text;
+	size_t len;
+
 	if (argc != 2)
 	{
-		Console_Printf("Usage: playmusic <trackname>");
+		Console_Printf("Usage: exec <filename>");
+		return 0;
+	}
+
+	/* look in the preferences directory first, then next to the game */
+	io = FS_OpenFile(argv[1], "rb", FS_PATH_PREF);
+	if (!io)
+		io = FS_OpenFile(argv[1], "rb", FS_PATH_BASE);
+	if (!io)
+		return LogError("exec: Couldn't open \"%s\"", argv[1]);
+
+	text = SDL_LoadFile_IO(io, &len, SDL_TRUE);
+	if (!text)
+		return LogError("exec: Couldn't read \"%s\": %s", argv[1], SDL_GetError());
+
+	Log("Executing \"%s\"", argv[1]);
+
+	/* run script before anything else that's queued */
+	Console_InsertText(text);
+
+	SDL_free(text);
+
+	return 0;
+}
+
+static int CMD_Wait(int argc, char **argv)
+{
+	if (argc > 2)
+	{
+		Console_Printf("Usage: wait [ticks]");
+		return 0;
+	}
+
+	wait_ticks = argc == 2 ? SDL_max(SDL_atoi(argv[1]), 0) : 1;
+
+	return 0;
+}
+
+static int CMD_ProfileDump(int argc, char **argv)
+{
+	if (argc > 2)
+	{
+		Console_Printf("Usage: profile_dump [filename]");
+		return 0;
+	}
+
+	Profiler_Dump(argc == 2 ? argv[1] : "profile.json");
+
+	return 0;
+}
+
+static int CMD_ProfileClear(int argc, char **argv)
+{
+	Profiler_Clear();
+	return 0;
+}
+
+static int CMD_LogPriority(int argc, char **argv)
+{
+	int category;
+	SDL_LogPriority priority;
+
+	if (argc > 3)
+	{
+		Console_Printf("Usage: log_priority [category] [verbose|debug|info|warn|error|critical|off]");
+		return 0;
+	}
+
+	/* list all categories */
+	if (argc == 1)
+	{
+		for (int i = 0; i < LOG_NUM_CATEGORIES; i++)
+		{
+			if (Logging_GetCategoryName(i))
+				Console_Printf("%s: %s", Logging_GetCategoryName(i), Logging_GetPriorityName(log_priorities[i]));
+		}
+
+		return 0;
+	}
+
+	if ((category = Logging_FindCategory(argv[1])) < 0)
+	{
+		Console_Printf("\"%s\" is not a valid log category", argv[1]);
+		return 0;
+	}
+
+	if (argc == 2)
+	{
+		Console_Printf("%s: %s", argv[1], Logging_GetPriorityName(log_priorities[category]));
+		return 0;
+	}
+
+	if ((priority = Logging_FindPriority(argv[2])) == 0)
+	{
+		Console_Printf("\"%s\" is not a valid log priority", argv[2]);
+		return 0;
+	}
+
+	Logging_SetPriority(category, priority);
+
+	return 0;
+}
+
+static int CMD_LogRateLimit(int argc, char **argv)
+{
+	if (argc > 2)
+	{
+		Console_Printf("Usage: log_ratelimit [messages per second, 0 to disable]");
 		return 0;
 	}
 
-	if (AU_PlayMusic(argv[1], SDL_FALSE) == 0)
-		Console_Printf("Playing %s", argv[1]);
+	if (argc == 2)
+		Logging_SetRateLimit(SDL_atoi(argv[1]));
+	else
+		Console_Printf("log_ratelimit: %d", Logging_GetRateLimit());
 
 	return 0;
 }
 
-static int CMD_StopMusic(int argc, char **argv)
+static int CMD_CmdList(int argc, char **argv)
 {
-	AU_StopMusic();
+	for (int i = 0; i < max_entries; i++)
+	{
+		if (entries[i].name && entries[i].func)
+			Console_Printf("%s", entries[i].name);
+	}
+
+	return 0;
+}
+
+static int CMD_CvarList(int argc, char **argv)
+{
+	for (int i = 0; i < max_entries; i++)
+	{
+		if (entries[i].name && entries[i].cvar)
+			Console_Printf("%s: %s (default: %s)", entries[i].name, entries[i].cvar->value_string, entries[i].cvar->value_default);
+	}
+
 	return 0;
 }
 
@@ -101,18 +266,14 @@ static int CMD_Quit(int argc, char **argv)
 static cmd_t cmds[] = {
 	{"quit", CMD_Quit},
 	{"exit", CMD_Quit},
-	{"playmusic", CMD_PlayMusic},
-	{"stopmusic", CMD_StopMusic}
-};
-
-/*
- *
- * cvars
- *
- */
-
-static cvar_t cvars[] = {
-	{"music_volume", "0.5"}
+	{"exec", CMD_Exec},
+	{"wait", CMD_Wait},
+	{"cmdlist", CMD_CmdList},
+	{"cvarlist", CMD_CvarList},
+	{"profile_dump", CMD_ProfileDump},
+	{"profile_clear", CMD_ProfileClear},
+	{"log_priority", CMD_LogPriority},
+	{"log_ratelimit", CMD_LogRateLimit}
 };
 
 /*
@@ -124,10 +285,13 @@ static cvar_t cvars[] = {
 static char **tokenize(const char *s, int *num_args)
 {
 	static char *argv[32];
+	static char buf[CON_CMDLINESIZE];
 	int argc = 0;
 	char *ptr, *end;
 
-	ptr = (char *)s;
+	/* tokens are split in place */
+	SDL_strlcpy(buf, s, sizeof(buf));
+	ptr = buf;
 	for(;;)
 	{
 		while(*ptr && isspace(*ptr))
@@ -156,19 +320,142 @@ static char **tokenize(const char *s, int *num_args)
 	return argv;
 }
 
-static void push_line(char *ptr)
+/* case insensitive fnv-1a */
+static Uint32 hash_name(const char *name)
 {
-	/* add line */
-	lines[num_lines++] = ptr;
+	Uint32 hash = 2166136261u;
+
+	while (*name)
+	{
+		hash ^= (Uint8)SDL_tolower(*name++);
+		hash *= 16777619u;
+	}
 
-	/* do memmove if we've hit the screen edge */
-	if (num_lines >= CON_NUMLINES - 1)
+	return hash;
+}
+
+/* find registry slot for name, either the one holding it or the empty one
+ * it would go into */
+static entry_t *find_slot(entry_t *table, int size, const char *name, Uint32 hash)
+{
+	for (int i = hash & (size - 1);; i = (i + 1) & (size - 1))
 	{
-		SDL_memmove(&lines[0], &lines[1], (CON_NUMLINES - 1) * sizeof(char *));
-		num_lines = CON_NUMLINES - 2;
+		if (!table[i].name)
+			return &table[i];
+
+		if (table[i].hash == hash && SDL_strcasecmp(table[i].name, name) == 0)
+			return &table[i];
 	}
 }
 
+static entry_t *find_entry(const char *name)
+{
+	entry_t *entry;
+
+	if (!entries)
+		return NULL;
+
+	entry = find_slot(entries, max_entries, name, hash_name(name));
+
+	return entry->name ? entry : NULL;
+}
+
+/* add registry entry, growing the table to keep it at most 3/4 full */
+static entry_t *add_entry(const char *name)
+{
+	entry_t *entry;
+	Uint32 hash = hash_name(name);
+
+	if ((num_entries + 1) * 4 > max_entries * 3)
+	{
+		int new_max = max_entries ? max_entries * 2 : CON_MINENTRIES;
+		entry_t *new_entries = SDL_calloc(new_max, sizeof(entry_t));
+		if (!new_entries)
+			return NULL;
+
+		for (int i = 0; i < max_entries; i++)
+		{
+			if (entries[i].name)
+				*find_slot(new_entries, new_max, entries[i].name, entries[i].hash) = entries[i];
+		}
+
+		SDL_free(entries);
+		entries = new_entries;
+		max_entries = new_max;
+	}
+
+	entry = find_slot(entries, max_entries, name, hash);
+	if (entry->name)
+		return NULL;
+
+	if (!(entry->name = SDL_strdup(name)))
+		return NULL;
+
+	entry->hash = hash;
+	num_entries++;
+
+	return entry;
+}
+
+static void free_entries(void)
+{
+	for (int i = 0; i < max_entries; i++)
+	{
+		if (entries[i].cvar)
+		{
+			SDL_free(entries[i].cvar->value_string);
+			SDL_free(entries[i].cvar->value_default);
+			SDL_free(entries[i].cvar);
+		}
+
+		SDL_free(entries[i].name);
+	}
+
+	SDL_free(entries);
+	entries = NULL;
+	num_entries = max_entries = 0;
+}
+
+/* add line to scrollback, must hold mutex */
+static void push_line(const char *s, int len)
+{
+	Uint64 start;
+
+	len = SDL_min(len, CON_MAXLINELEN);
+
+	/* keep lines contiguous, skip to the start of the ring if it doesn't fit */
+	if ((text_head & (CON_BUFSIZE - 1)) + len + 1 > CON_BUFSIZE)
+		text_head = (text_head + CON_BUFSIZE) & ~(Uint64)(CON_BUFSIZE - 1);
+
+	start = text_head;
+	text_head += len + 1;
+
+	/* drop lines that are about to be overwritten */
+	while (first_line < next_line && line_offsets[first_line & (CON_MAXLINES - 1)] + CON_BUFSIZE < text_head)
+		first_line++;
+
+	/* drop oldest line if the index is full */
+	if (next_line - first_line >= CON_MAXLINES)
+		first_line++;
+
+	SDL_memcpy(&textbuf[start & (CON_BUFSIZE - 1)], s, len);
+	textbuf[(start & (CON_BUFSIZE - 1)) + len] = '\0';
+
+	line_offsets[next_line & (CON_MAXLINES - 1)] = start;
+	next_line++;
+
+	/* keep the view still while scrolled back */
+	if (scroll > 0)
+		scroll++;
+}
+
+/* clamp scroll to the available lines, must hold mutex */
+static void clamp_scroll(void)
+{
+	scroll = SDL_min(scroll, (int)(next_line - first_line) - Console_GetVisibleLines());
+	scroll = SDL_max(scroll, 0);
+}
+
 /*
  *
  * public
@@ -177,74 +464,87 @@ static void push_line(char *ptr)
 
 int Console_Init(void)
 {
+	PROFILE_FUNCTION();
+
 	if (started)
 		return LogError("Console_Init(): Already started");
 
+	/* text buffer is written to by the logging thread */
+	mutex = SDL_CreateMutex();
+	if (!mutex)
+		return LogError("Console_Init(): %s", SDL_GetError());
+
 	started = SDL_TRUE;
 
-	/* set text buffer pointer */
-	textbuf_ptr = textbuf;
+	/* reset scrollback */
+	text_head = first_line = next_line = 0;
+	scroll = 0;
+
+	/* reset command buffer */
+	cmdbuf_len = 0;
+	wait_ticks = 0;
 
 	/* setup input buffer */
 	Console_ClearInput();
 
+	/* register builtin commands */
+	for (int i = 0; i < ASIZE(cmds); i++)
+		Console_RegisterCommand(cmds[i].name, cmds[i].func);
+
 	return Log("Console initialized");
 }
 
 void Console_Quit(void)
 {
+	PROFILE_FUNCTION();
+
+	SDL_LockMutex(mutex);
 	started = SDL_FALSE;
-	SDL_memset(textbuf, 0, sizeof(textbuf));
-	textbuf_ptr = NULL;
-	SDL_memset(lines, 0, sizeof(lines));
-	num_lines = 0;
+	text_head = first_line = next_line = 0;
+	scroll = 0;
 	SDL_memset(input, 0, sizeof(input));
 	input_len = 0;
 	input_cursor = 0;
+	SDL_UnlockMutex(mutex);
 
-	for (int i = 0; i < ASIZE(cvars); i++)
-	{
-		if (cvars[i].value_string)
-			SDL_free(cvars[i].value_string);
+	SDL_DestroyMutex(mutex);
+	mutex = NULL;
 
-		cvars[i].value_string = NULL;
-	}
+	free_entries();
 }
 
 void Console_Print(const char *s)
 {
-	int i;
-	int len_src = SDL_strlen(s);
+	PROFILE_FUNCTION();
+
+	const char *end;
+
+	SDL_LockMutex(mutex);
 
 	if (!started)
+	{
+		SDL_UnlockMutex(mutex);
 		return;
+	}
 
-	/* bounds checks */
-	if (textbuf_ptr + len_src + 1 > textbuf + CON_BUFSIZE)
-		textbuf_ptr = textbuf;
-
-	/* add string to text buffer */
-	SDL_snprintf(textbuf_ptr, CON_BUFSIZE, "%s", s);
+	/* add a line for every newline */
+	while ((end = SDL_strchr(s, '\n')) != NULL)
+	{
+		push_line(s, end - s);
+		s = end + 1;
+	}
 
-	/* add pointer to lines buffer */
-	push_line(textbuf_ptr);
+	push_line(s, SDL_strlen(s));
 
-	/* advance text buffer pointer */
-	textbuf_ptr += len_src + 1;
+	clamp_scroll();
 
-	/* check for newlines and push line again */
-	for (i = 0; i < len_src; i++)
-	{
-		if (textbuf_ptr[i] == '\n')
-		{
-			textbuf_ptr[i] = '\0';
-			push_line(&textbuf_ptr[i + 1]);
-		}
-	}
+	SDL_UnlockMutex(mutex);
 }
 
 void Console_Printf(const char *fmt, ...)
 {
+	PROFILE_FUNCTION();
+
 	static char line[CON_LINESIZE];
 	va_list args;
 
@@ -262,60 +562,131 @@ void Console_Printf(const char *fmt, ...)
 
 void Console_Evaluate(const char *s)
 {
+	PROFILE_FUNCTION();
+
 	int argc;
 	char **argv = tokenize(s, &argc);
+	entry_t *entry;
 
 	if (!argv || argc < 1)
 		return;
 
-	/* search for cmd */
-	for (int i = 0; i < ASIZE(cmds); i++)
+	entry = find_entry(argv[0]);
+	if (!entry)
 	{
-		if (SDL_strcasecmp(argv[0], cmds[i].name) == 0)
-		{
-			cmds[i].func(argc, argv);
-			return;
-		}
+		Log("\"%s\" is not a valid command or cvar", argv[0]);
+		return;
 	}
 
-	/* search for cvar */
-	for (int i = 0; i < ASIZE(cvars); i++)
+	/* run command */
+	if (entry->func)
 	{
-		if (SDL_strcasecmp(argv[0], cvars[i].name) == 0)
-		{
-			if (argc > 1)
-			{
-				/* set cvar value */
-				if (cvars[i].value_string)
-					Log("%s: Changed from %s to %s", cvars[i].name, cvars[i].value_string, argv[1]);
-				else
-					Log("%s: Changed from %s to %s", cvars[i].name, cvars[i].value_default, argv[1]);
-
-				if (cvars[i].value_string)
-					SDL_free(cvars[i].value_string);
-
-				cvars[i].value_string = SDL_strdup(argv[1]);
-				cvars[i].value_int = SDL_atoi(argv[1]);
-				cvars[i].value_float = SDL_atof(argv[1]);
-			}
-			else
-			{
-				/* print cvar value */
-				if (cvars[i].value_string)
-					Log("%s: %s (default: %s)", cvars[i].name, cvars[i].value_string, cvars[i].value_default);
-				else
-					Log("%s: %s (default)", cvars[i].name, cvars[i].value_default);
-			}
+		entry->func(argc, argv);
+		return;
+	}
 
-			return;
+	/* set cvar value */
+	if (argc > 1)
+	{
+		char *old_value = SDL_strdup(entry->cvar->value_string);
+
+		if (Console_SetCvar(entry->cvar, argv[1]) == 0)
+			Log("%s: Changed from %s to %s", entry->cvar->name, old_value, entry->cvar->value_string);
+
+		SDL_free(old_value);
+		return;
+	}
+
+	/* print cvar value */
+	if (SDL_strcmp(entry->cvar->value_string, entry->cvar->value_default) == 0)
+		Log("%s: %s (default)", entry->cvar->name, entry->cvar->value_string);
+	else
+		Log("%s: %s (default: %s)", entry->cvar->name, entry->cvar->value_string, entry->cvar->value_default);
+}
+
+int Console_AddText(const char *text)
+{
+	int len = SDL_strlen(text);
+
+	/* always ends with a separator */
+	if (cmdbuf_len + len + 1 > CON_CMDBUFSIZE)
+		return LogError("Console_AddText(): Command buffer overflow");
+
+	SDL_memcpy(&cmdbuf[cmdbuf_len], text, len);
+	cmdbuf_len += len;
+	cmdbuf[cmdbuf_len++] = '\n';
+
+	return 0;
+}
+
+int Console_InsertText(const char *text)
+{
+	int len = SDL_strlen(text);
+
+	if (cmdbuf_len + len + 1 > CON_CMDBUFSIZE)
+		return LogError("Console_InsertText(): Command buffer overflow");
+
+	SDL_memmove(&cmdbuf[len + 1], cmdbuf, cmdbuf_len);
+	SDL_memcpy(cmdbuf, text, len);
+	cmdbuf[len] = '\n';
+	cmdbuf_len += len + 1;
+
+	return 0;
+}
+
+void Console_Execute(void)
+{
+	PROFILE_FUNCTION();
+
+	char line[CON_CMDLINESIZE];
+
+	/* still waiting */
+	if (wait_ticks > 0 && --wait_ticks > 0)
+		return;
+
+	while (cmdbuf_len > 0 && wait_ticks == 0)
+	{
+		int len = 0;
+		char *ptr;
+
+		/* commands are separated by newlines or semicolons */
+		while (len < cmdbuf_len && cmdbuf[len] != '\n' && cmdbuf[len] != ';')
+			len++;
+
+		/* running a truncated command could do anything */
+		if (len >= (int)sizeof(line))
+		{
+			LogWarning("Console_Execute(): Skipping command longer than %d characters: \"%.32s...\"", (int)sizeof(line) - 1, cmdbuf);
+			line[0] = '\0';
+		}
+		else
+		{
+			SDL_strlcpy(line, cmdbuf, len + 1);
 		}
+
+		/* remove it from the buffer, including the separator */
+		len = SDL_min(len + 1, cmdbuf_len);
+		SDL_memmove(cmdbuf, &cmdbuf[len], cmdbuf_len - len);
+		cmdbuf_len -= len;
+
+		/* skip blank lines and comments */
+		for (ptr = line; *ptr && isspace(*ptr); ptr++);
+		if (!*ptr || *ptr == '#' || (ptr[0] == '/' && ptr[1] == '/'))
+			continue;
+
+		Console_Evaluate(ptr);
 	}
+}
 
-	Log("\"%s\" is not a valid command or cvar", argv[0]);
+SDL_bool Console_IsIdle(void)
+{
+	return cmdbuf_len == 0 && wait_ticks == 0;
 }
 
 void Console_HandleInput(int c)
 {
+	PROFILE_FUNCTION();
+
 	if (!started)
 		return;
 
@@ -325,11 +696,23 @@ void Console_HandleInput(int c)
 		case '\n':
 		case '\r':
 			input[input_len] = '\0';
+			Console_Lock();
+			scroll = 0;
+			Console_Unlock();
 			Log(input);
 			Console_Evaluate(&input[1]);
 			Console_ClearInput();
 			break;
 
+		/* scrollback */
+		case SDLK_PAGEUP:
+		case SDLK_PAGEDOWN:
+			Console_Lock();
+			scroll += c == SDLK_PAGEUP ? Console_GetVisibleLines() / 2 : -(Console_GetVisibleLines() / 2);
+			clamp_scroll();
+			Console_Unlock();
+			break;
+
 		/* backspace */
 		case '\b':
 			if (input_len > CON_PREFIXSIZE)
@@ -365,14 +748,19 @@ void Console_HandleInput(int c)
 
 void Console_Clear(void)
 {
-	SDL_memset(textbuf, 0, sizeof(textbuf));
-	textbuf_ptr = textbuf;
-	SDL_memset(lines, 0, sizeof(lines));
+	PROFILE_FUNCTION();
+
+	SDL_LockMutex(mutex);
+	text_head = first_line = next_line = 0;
+	scroll = 0;
+	SDL_UnlockMutex(mutex);
 	Console_ClearInput();
 }
 
 void Console_ClearInput(void)
 {
+	PROFILE_FUNCTION();
+
 	/* clear buffer */
 	SDL_memset(input, 0, sizeof(input));
 	input_len = input_cursor = CON_PREFIXSIZE;
@@ -382,13 +770,189 @@ void Console_ClearInput(void)
 	input[1] = ' ';
 }
 
-char **Console_GetLines(int *n)
+void Console_Lock(void)
+{
+	SDL_LockMutex(mutex);
+}
+
+void Console_Unlock(void)
 {
-	if (n) *n = num_lines;
-	return lines;
+	SDL_UnlockMutex(mutex);
+}
+
+int Console_GetNumLines(void)
+{
+	return next_line - first_line;
+}
+
+const char *Console_GetLine(int i)
+{
+	if (i < 0 || i >= next_line - first_line)
+		return NULL;
+
+	return &textbuf[line_offsets[(first_line + i) & (CON_MAXLINES - 1)] & (CON_BUFSIZE - 1)];
+}
+
+int Console_GetScroll(void)
+{
+	return scroll;
+}
+
+/* called by the logging thread too, so it never touches the screen surface */
+int Console_GetVisibleLines(void)
+{
+	int height = R_GetScreenHeight();
+
+	return ((height > 0 ? height : RENDER_HEIGHT) / CON_FONTHEIGHT) - 1;
 }
 
 char *Console_GetInputLine(void)
 {
 	return input;
 }
+
+int Console_RegisterCommand(const char *name, cmd_func_t func)
+{
+	entry_t *entry;
+
+	/* stoopid */
+	if (!name || !func)
+		return LogError("Console_RegisterCommand(): NULL pointer passed as name or function");
+
+	if (find_entry(name))
+		return LogError("Console_RegisterCommand(): \"%s\" is already registered", name);
+
+	if (!(entry = add_entry(name)))
+		return LogError("Console_RegisterCommand(): Failed to register \"%s\"", name);
+
+	entry->func = func;
+
+	return 0;
+}
+
+cvar_t *Console_RegisterCvar(const char *name, const char *value_default, cvar_type_t type, cvar_callback_t callback)
+{
+	entry_t *entry;
+	cvar_t *cvar;
+
+	/* stoopid */
+	if (!name || !value_default)
+	{
+		LogError("Console_RegisterCvar(): NULL pointer passed as name or default value");
+		return NULL;
+	}
+
+	/* already registered, hand out the existing one */
+	if ((entry = find_entry(name)) != NULL)
+	{
+		if (!entry->cvar || entry->cvar->type != type)
+		{
+			LogError("Console_RegisterCvar(): \"%s\" is already registered", name);
+			return NULL;
+		}
+
+		/* keep the callback it was first given */
+		if (!entry->cvar->callback)
+			entry->cvar->callback = callback;
+		else if (callback && callback != entry->cvar->callback)
+			LogError("Console_RegisterCvar(): \"%s\" is already registered with a different callback", name);
+
+		return entry->cvar;
+	}
+
+	if (!(cvar = SDL_calloc(1, sizeof(cvar_t))))
+	{
+		LogError("Console_RegisterCvar(): Memory allocation of %zu bytes failed", sizeof(cvar_t));
+		return NULL;
+	}
+
+	if (!(entry = add_entry(name)))
+	{
+		LogError("Console_RegisterCvar(): Failed to register \"%s\"", name);
+		SDL_free(cvar);
+		return NULL;
+	}
+
+	entry->cvar = cvar;
+	cvar->name = entry->name;
+	cvar->value_default = SDL_strdup(value_default);
+	cvar->type = type;
+	cvar->callback = callback;
+
+	/* set default value, this also runs the callback */
+	if (Console_SetCvar(cvar, value_default) != 0)
+		LogWarning("Console_RegisterCvar(): Invalid default value \"%s\" for \"%s\"", value_default, name);
+
+	return cvar;
+}
+
+cvar_t *Console_FindCvar(const char *name)
+{
+	entry_t *entry = find_entry(name);
+	return entry ? entry->cvar : NULL;
+}
+
+int Console_SetCvar(cvar_t *cvar, const char *value)
+{
+	char *end;
+	char *value_string;
+	Sint32 value_int;
+	float value_float;
+
+	/* stoopid */
+	if (!cvar || !value)
+		return LogError("Console_SetCvar(): NULL pointer passed as cvar or value");
+
+	/* parse and validate */
+	switch (cvar->type)
+	{
+		case CVAR_INT:
+			value_int = SDL_strtol(value, &end, 0);
+			if (end == value || *end)
+				return LogError("%s: \"%s\" is not an integer", cvar->name, value);
+			value_float = value_int;
+			break;
+
+		case CVAR_FLOAT:
+			value_float = SDL_strtod(value, &end);
+			if (end == value || *end)
+				return LogError("%s: \"%s\" is not a number", cvar->name, value);
+			value_int = value_float;
+			break;
+
+		case CVAR_BOOL:
+			if (SDL_strcmp(value, "1") == 0 || SDL_strcasecmp(value, "true") == 0 || SDL_strcasecmp(value, "on") == 0)
+				value_int = 1;
+			else if (SDL_strcmp(value, "0") == 0 || SDL_strcasecmp(value, "false") == 0 || SDL_strcasecmp(value, "off") == 0)
+				value_int = 0;
+			else
+				return LogError("%s: \"%s\" is not a boolean", cvar->name, value);
+			value_float = value_int;
+			value = value_int ? "1" : "0";
+			break;
+
+		default:
+			value_int = SDL_atoi(value);
+			value_float = SDL_atof(value);
+			break;
+	}
+
+	if (!(value_string = SDL_strdup(value)))
+		return LogError("Console_SetCvar(): Memory allocation failed");
+
+	SDL_free(cvar->value_string);
+	cvar->value_string = value_string;
+	cvar->value_int = value_int;
+	cvar->value_float = value_float;
+
+	if (cvar->callback)
+		cvar->callback(cvar);
+
+	return 0;
+}
+
+Sint32 Console_GetCvarInt(const char *name)
+{
+	cvar_t *cvar = Console_FindCvar(name);
+	return cvar ? cvar->value_int : 0;
+}
@@ -29,24 +29,99 @@ SOFTWARE.
 extern "C" {
 #endif
 
+typedef int (*cmd_func_t)(int argc, char **argv);
+
+typedef enum cvar_type {
+	CVAR_STRING,
+	CVAR_INT,
+	CVAR_FLOAT,
+	CVAR_BOOL
+} cvar_type_t;
+
+typedef struct cvar cvar_t;
+
+/* called after the value of a cvar has changed */
+typedef void (*cvar_callback_t)(cvar_t *cvar);
+
+/* value_int and value_float are kept in sync with value_string, so they can
+ * be read directly in hot paths */
+struct cvar {
+	const char *name;
+	char *value_default;
+	cvar_type_t type;
+	cvar_callback_t callback;
+	char *value_string;
+	float value_float;
+	Sint32 value_int;
+};
+
 int Console_Init(void);
 
+/* frees every cvar, so it has to run after the modules holding cvar pointers have quit */
 void Console_Quit(void);
 
 void Console_Print(const char *s);
 
 void Console_Printf(const char *fmt, ...);
 
+/* run a single command line right away */
+void Console_Evaluate(const char *s);
+
+/* queue commands to run at the end of the command buffer, separated by
+ * newlines or semicolons */
+int Console_AddText(const char *text);
+
+/* queue commands to run before everything else in the command buffer */
+int Console_InsertText(const char *text);
+
+/* run queued commands, until the buffer is empty or a wait command is hit.
+ * called once per tick */
+void Console_Execute(void);
+
+/* returns SDL_TRUE if no commands are queued or waiting */
+SDL_bool Console_IsIdle(void);
+
 void Console_HandleInput(int c);
 
 void Console_Clear(void);
 
 void Console_ClearInput(void);
 
-char **Console_GetLines(int *n);
+/* lock scrollback while reading lines, as it may be written to by other threads */
+void Console_Lock(void);
+
+void Console_Unlock(void);
+
+/* number of lines in scrollback */
+int Console_GetNumLines(void);
+
+/* get scrollback line, 0 is the oldest */
+const char *Console_GetLine(int i);
+
+/* number of lines scrolled back from the newest */
+int Console_GetScroll(void);
+
+/* number of scrollback lines that fit on screen above the input line */
+int Console_GetVisibleLines(void);
 
 char *Console_GetInputLine(void);
 
+/* register console command */
+int Console_RegisterCommand(const char *name, cmd_func_t func);
+
+/* register cvar and set it to its default value, returns the existing cvar if
+ * one of the same type is already registered, which keeps its callback */
+cvar_t *Console_RegisterCvar(const char *name, const char *value_default, cvar_type_t type, cvar_callback_t callback);
+
+/* find registered cvar, or NULL */
+cvar_t *Console_FindCvar(const char *name);
+
+/* set cvar value, fails if it can't be parsed as the cvar type */
+int Console_SetCvar(cvar_t *cvar, const char *value);
+
+/* get integer value of cvar, or 0 if it doesn't exist */
+Sint32 Console_GetCvarInt(const char *name);
+
 #ifdef __cplusplus
 }
 #endif
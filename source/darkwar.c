@@ -127,3 +127,55 @@ const char *DarkWar_GetWallTexture(int tile)
 
 	return wall_tiles[tile];
 }
+
+/* static objects in the sprite plane, the rest aren't drawn yet */
+static const char *sprite_objects[] = {
+	/* 19-22 are player starts */
+	[23] = "YLIGHT",
+	[24] = "RLIGHT",
+	[25] = "GLIGHT",
+	[26] = "BLIGHT",
+	[27] = "CHAND",
+	[28] = "LAMPOFF"
+};
+
+static const int num_sprite_objects = sizeof(sprite_objects) / sizeof(const char *);
+
+/* retrieve sprite name from sprite plane object */
+const char *DarkWar_GetSprite(int obj)
+{
+	if (obj < 0 || obj >= num_sprite_objects)
+		return NULL;
+
+	return sprite_objects[obj];
+}
+
+/* floors and ceilings share the same 16 flats */
+#define NUM_FLATS (16)
+#define FLOOR_TILE_FIRST (180)
+#define CEILING_TILE_FIRST (198)
+
+static const char *flats[NUM_FLATS] = {
+	"FLRCL1", "FLRCL2", "FLRCL3", "FLRCL4",
+	"FLRCL5", "FLRCL6", "FLRCL7", "FLRCL8",
+	"FLRCL9", "FLRCL10", "FLRCL11", "FLRCL12",
+	"FLRCL13", "FLRCL14", "FLRCL15", "FLRCL16"
+};
+
+/* retrieve floor flat name from floor tile */
+const char *DarkWar_GetFloorTexture(int tile)
+{
+	if (tile < FLOOR_TILE_FIRST || tile >= FLOOR_TILE_FIRST + NUM_FLATS)
+		return NULL;
+
+	return flats[tile - FLOOR_TILE_FIRST];
+}
+
+/* retrieve ceiling flat name from ceiling tile, sky tiles 234-238 have none */
+const char *DarkWar_GetCeilingTexture(int tile)
+{
+	if (tile < CEILING_TILE_FIRST || tile >= CEILING_TILE_FIRST + NUM_FLATS)
+		return NULL;
+
+	return flats[tile - CEILING_TILE_FIRST];
+}
@@ -32,6 +32,15 @@ extern "C" {
 /* retrieve wall texture name from tile index */
 const char *DarkWar_GetWallTexture(int tile);
 
+/* retrieve sprite name from sprite plane object */
+const char *DarkWar_GetSprite(int obj);
+
+/* retrieve floor flat name from the floor tile in the map's first corner */
+const char *DarkWar_GetFloorTexture(int tile);
+
+/* retrieve ceiling flat name from the ceiling tile next to it, NULL for skies */
+const char *DarkWar_GetCeilingTexture(int tile);
+
 #ifdef __cplusplus
 }
 #endif
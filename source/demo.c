@@ -0,0 +1,404 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * demo recording and playback
+ *
+ * a demo is the map it was recorded on, followed by every game tick: the key
+ * events that reached the game during the tick, then the usercmd built from
+ * them. playback replays the events and runs the recorded usercmds, so the
+ * same demo always runs the same number of ticks. timedemo renders one frame
+ * per tick as fast as possible and reports frame times at the end.
+ *
+ * all values are little endian:
+ *
+ * header: char magic[4], Uint8 version, Uint8 map
+ * tick: Uint8 num_events, {Uint8 down, Uint32 key}[num_events],
+ *       Sint8 forward, Sint8 side, Sint16 turn, Uint8 buttons
+ * end: Uint8 DEMO_END
+ */
+
+#include "neurottic.h"
+
+/*
+ *
+ * types & defines
+ *
+ */
+
+#define DEMO_MAGIC "NDEM"
+#define DEMO_VERSION (2)
+#define DEMO_END (0xFF)
+#define DEMO_MAXEVENTS (64)
+
+typedef struct demo_event {
+	Uint8 down;
+	Uint32 key;
+} demo_event_t;
+
+/*
+ *
+ * globals
+ *
+ */
+
+/* recording */
+static SDL_IOStream *record_io = NULL;
+static demo_event_t events[DEMO_MAXEVENTS];
+static int num_events = 0;
+static Uint32 record_ticks = 0;
+
+/* playback */
+static SDL_IOStream *playback_io = NULL;
+static void *playback_data = NULL;
+static SDL_bool timedemo = SDL_FALSE;
+
+/* timedemo frame times, in performance counter units */
+static Uint32 timing_frames = 0;
+static Uint64 timing_start = 0;
+static Uint64 timing_last = 0;
+static Uint64 timing_worst = 0;
+
+/* vsync to go back to once the timedemo is over */
+static SDL_bool timing_vsync = SDL_FALSE;
+
+/*
+ *
+ * private
+ *
+ */
+
+/* open demo file, adding an extension if there isn't one */
+static SDL_IOStream *OpenDemo(const char *name, const char *mode)
+{
+	char filename[256];
+
+	if (SDL_strchr(name, '.'))
+		SDL_strlcpy(filename, name, sizeof(filename));
+	else
+		SDL_snprintf(filename, sizeof(filename), "%s.dem", name);
+
+	return FS_OpenFile(filename, mode, FS_PATH_PREF);
+}
+
+/* track time between frames while timing */
+static void TimeFrame(void)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (timing_frames > 0)
+		timing_worst = SDL_max(timing_worst, now - timing_last);
+	else
+		timing_start = now;
+
+	timing_last = now;
+}
+
+/*
+ *
+ * console
+ *
+ */
+
+static int CMD_Record(int argc, char **argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		Console_Printf("Usage: record <demoname> [map]");
+		return 0;
+	}
+
+	return Demo_StartRecording(argv[1], argc == 3 ? SDL_atoi(argv[2]) : MS_GetCurrentMap());
+}
+
+static int CMD_StopRecord(int argc, char **argv)
+{
+	if (!Demo_IsRecording())
+	{
+		Console_Printf("Not recording a demo");
+		return 0;
+	}
+
+	return Demo_StopRecording();
+}
+
+static int CMD_PlayDemo(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		Console_Printf("Usage: %s <demoname>", argv[0]);
+		return 0;
+	}
+
+	return Demo_StartPlayback(argv[1], SDL_strcasecmp(argv[0], "timedemo") == 0);
+}
+
+/*
+ *
+ * public
+ *
+ */
+
+int Demo_Init(void)
+{
+	Console_RegisterCommand("record", CMD_Record);
+	Console_RegisterCommand("stoprecord", CMD_StopRecord);
+	Console_RegisterCommand("playdemo", CMD_PlayDemo);
+	Console_RegisterCommand("timedemo", CMD_PlayDemo);
+
+	return 0;
+}
+
+void Demo_Quit(void)
+{
+	if (Demo_IsRecording())
+		Demo_StopRecording();
+
+	if (Demo_IsPlaying())
+		Demo_StopPlayback();
+}
+
+int Demo_StartRecording(const char *name, int map)
+{
+	if (Demo_IsRecording())
+		return LogError("Demo_StartRecording(): Already recording a demo");
+
+	if (Demo_IsPlaying())
+		return LogError("Demo_StartRecording(): Can't record while playing back a demo");
+
+	if (map < 0)
+		return LogError("Demo_StartRecording(): No map to record on");
+
+	/* demos always start from the player start */
+	if (G_StartMap(map) != 0)
+		return -1;
+
+	record_io = OpenDemo(name, "wb");
+	if (!record_io)
+		return LogError("Demo_StartRecording(): Couldn't open \"%s\" for writing", name);
+
+	SDL_WriteIO(record_io, DEMO_MAGIC, 4);
+	SDL_WriteU8(record_io, DEMO_VERSION);
+	SDL_WriteU8(record_io, map);
+
+	num_events = 0;
+	record_ticks = 0;
+
+	return Log("Recording demo \"%s\" on map %d", name, map);
+}
+
+int Demo_StopRecording(void)
+{
+	if (!record_io)
+		return LogError("Demo_StopRecording(): Not recording a demo");
+
+	SDL_WriteU8(record_io, DEMO_END);
+
+	if (SDL_CloseIO(record_io) != 0)
+	{
+		record_io = NULL;
+		return LogError("Demo_StopRecording(): Failed to write demo: %s", SDL_GetError());
+	}
+
+	record_io = NULL;
+
+	return Log("Recorded demo of %u ticks", record_ticks);
+}
+
+int Demo_StartPlayback(const char *name, SDL_bool timing)
+{
+	SDL_IOStream *io;
+	size_t size;
+	char magic[4];
+	Uint8 version, map;
+
+	if (Demo_IsRecording())
+		return LogError("Demo_StartPlayback(): Can't play back while recording a demo");
+
+	if (Demo_IsPlaying())
+		Demo_StopPlayback();
+
+	/* read the whole demo up front, so playback doesn't touch the disk */
+	io = OpenDemo(name, "rb");
+	if (!io)
+		return LogError("Demo_StartPlayback(): Couldn't open \"%s\" for reading", name);
+
+	playback_data = SDL_LoadFile_IO(io, &size, SDL_TRUE);
+	if (!playback_data)
+		return LogError("Demo_StartPlayback(): Couldn't read \"%s\": %s", name, SDL_GetError());
+
+	playback_io = SDL_IOFromConstMem(playback_data, size);
+	if (!playback_io)
+	{
+		Demo_StopPlayback();
+		return LogError("Demo_StartPlayback(): %s", SDL_GetError());
+	}
+
+	/* check header */
+	if (SDL_ReadIO(playback_io, magic, 4) != 4 || SDL_memcmp(magic, DEMO_MAGIC, 4) != 0 ||
+		!SDL_ReadU8(playback_io, &version) || !SDL_ReadU8(playback_io, &map))
+	{
+		Demo_StopPlayback();
+		return LogError("Demo_StartPlayback(): \"%s\" is not a demo", name);
+	}
+
+	if (version != DEMO_VERSION)
+	{
+		Demo_StopPlayback();
+		return LogError("Demo_StartPlayback(): \"%s\" has unsupported version %d", name, version);
+	}
+
+	if (G_StartMap(map) != 0)
+	{
+		Demo_StopPlayback();
+		return -1;
+	}
+
+	timedemo = timing;
+	timing_frames = 0;
+	timing_worst = 0;
+
+	/* don't wait on the display while timing */
+	if (timedemo)
+	{
+		timing_vsync = R_GetVSync();
+		R_SetVSync(SDL_FALSE);
+	}
+
+	return Log("Playing demo \"%s\" on map %d", name, map);
+}
+
+void Demo_StopPlayback(void)
+{
+	if (timedemo && timing_frames > 0)
+	{
+		double frequency = (double)SDL_GetPerformanceFrequency();
+		double seconds = (double)(timing_last - timing_start) / frequency;
+
+		Log("timedemo: %u frames in %.3f seconds (%.1f fps), average %.3f ms, worst %.3f ms",
+			timing_frames, seconds, timing_frames / seconds,
+			seconds * 1000.0 / timing_frames, (double)timing_worst * 1000.0 / frequency);
+	}
+
+	if (timedemo)
+		R_SetVSync(timing_vsync);
+
+	if (playback_io)
+		SDL_CloseIO(playback_io);
+
+	SDL_free(playback_data);
+
+	playback_io = NULL;
+	playback_data = NULL;
+	timedemo = SDL_FALSE;
+
+	G_ClearInput();
+	G_SetGameState(GAMESTATE_CONSOLE);
+}
+
+SDL_bool Demo_IsRecording(void)
+{
+	return record_io != NULL;
+}
+
+SDL_bool Demo_IsPlaying(void)
+{
+	return playback_io != NULL;
+}
+
+SDL_bool Demo_IsTiming(void)
+{
+	return playback_io != NULL && timedemo;
+}
+
+void Demo_RecordEvent(const SDL_Event *event)
+{
+	if (!record_io || num_events >= DEMO_MAXEVENTS)
+		return;
+
+	events[num_events].down = event->type == SDL_EVENT_KEY_DOWN;
+	events[num_events].key = event->key.key;
+	num_events++;
+}
+
+void Demo_WriteTick(const usercmd_t *cmd)
+{
+	if (!record_io)
+		return;
+
+	SDL_WriteU8(record_io, num_events);
+
+	for (int i = 0; i < num_events; i++)
+	{
+		SDL_WriteU8(record_io, events[i].down);
+		SDL_WriteU32LE(record_io, events[i].key);
+	}
+
+	SDL_WriteU8(record_io, (Uint8)cmd->forward);
+	SDL_WriteU8(record_io, (Uint8)cmd->side);
+	SDL_WriteS16LE(record_io, cmd->turn);
+	SDL_WriteU8(record_io, cmd->buttons);
+
+	num_events = 0;
+	record_ticks++;
+}
+
+int Demo_ReadTick(usercmd_t *cmd)
+{
+	Uint8 count, forward, side;
+	Sint16 turn;
+
+	if (!playback_io)
+		return -1;
+
+	if (timedemo)
+		TimeFrame();
+
+	if (!SDL_ReadU8(playback_io, &count) || count == DEMO_END)
+		return -1;
+
+	/* replay events so held keys match the recording */
+	for (int i = 0; i < count; i++)
+	{
+		Uint8 down;
+		Uint32 key;
+
+		if (!SDL_ReadU8(playback_io, &down) || !SDL_ReadU32LE(playback_io, &key))
+			return LogError("Demo_ReadTick(): Demo is truncated");
+
+		G_SetKey(key, down);
+	}
+
+	if (!SDL_ReadU8(playback_io, &forward) || !SDL_ReadU8(playback_io, &side) ||
+		!SDL_ReadS16LE(playback_io, &turn) || !SDL_ReadU8(playback_io, &cmd->buttons))
+		return LogError("Demo_ReadTick(): Demo is truncated");
+
+	cmd->forward = (Sint8)forward;
+	cmd->side = (Sint8)side;
+	cmd->turn = turn;
+
+	timing_frames++;
+
+	return 0;
+}
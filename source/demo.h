@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _DEMO_H_
+#define _DEMO_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct usercmd;
+
+/* register demo commands */
+int Demo_Init(void);
+
+/* stop any demo being recorded or played back */
+void Demo_Quit(void);
+
+/* start recording a demo of map into the preferences directory */
+int Demo_StartRecording(const char *name, int map);
+
+/* finish writing demo being recorded */
+int Demo_StopRecording(void);
+
+/* start playing back a demo, as fast as possible if timedemo is set */
+int Demo_StartPlayback(const char *name, SDL_bool timedemo);
+
+/* stop playing back demo, reporting timings if it was a timedemo */
+void Demo_StopPlayback(void);
+
+/* returns SDL_TRUE if a demo is being recorded */
+SDL_bool Demo_IsRecording(void);
+
+/* returns SDL_TRUE if a demo is being played back */
+SDL_bool Demo_IsPlaying(void);
+
+/* returns SDL_TRUE if a demo is being played back as fast as possible */
+SDL_bool Demo_IsTiming(void);
+
+/* record input event for the current tick */
+void Demo_RecordEvent(const SDL_Event *event);
+
+/* record usercmd, ending the current tick */
+void Demo_WriteTick(const struct usercmd *cmd);
+
+/* replay the events of the next tick and read its usercmd, returns -1 at the end of the demo */
+int Demo_ReadTick(struct usercmd *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DEMO_H_ */
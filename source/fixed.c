@@ -0,0 +1,214 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "neurottic.h"
+
+/* the tables are constant data so every build agrees on them to the bit */
+#include "fixed_tables.h"
+
+/* integer square root of a 64-bit value */
+static Uint32 isqrt64(Uint64 x)
+{
+	Uint64 result = 0;
+	Uint64 bit = (Uint64)1 << 62;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit)
+	{
+		if (x >= result + bit)
+		{
+			x -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return (Uint32)result;
+}
+
+/* num / den scaled to the slope table, den must be at least num */
+static int slopediv(Uint32 num, Uint32 den)
+{
+	return (int)(((Uint64)num * SLOPERANGE) / den);
+}
+
+fixed_t fixsin(angle_t angle)
+{
+	return finesine[angle & FINEMASK];
+}
+
+fixed_t fixcos(angle_t angle)
+{
+	return finesine[(angle & FINEMASK) + ANG90];
+}
+
+angle_t fixatan2(fixed_t y, fixed_t x)
+{
+	Uint32 ax = x < 0 ? -(Uint32)x : (Uint32)x;
+	Uint32 ay = y < 0 ? -(Uint32)y : (Uint32)y;
+	angle_t angle;
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	/* angle within the first quadrant */
+	if (ax > ay)
+		angle = tantoangle[slopediv(ay, ax)];
+	else
+		angle = ANG90 - tantoangle[slopediv(ax, ay)];
+
+	/* mirror into the right quadrant */
+	if (x < 0)
+		angle = ANG180 - angle;
+	if (y < 0)
+		angle = -angle;
+
+	return angle & FINEMASK;
+}
+
+fixed_t fixsqrt(fixed_t x)
+{
+	if (x <= 0)
+		return 0;
+
+	return (fixed_t)isqrt64((Uint64)x << FRACBITS);
+}
+
+fixed_t fixhypot(fixed_t dx, fixed_t dy)
+{
+	Sint64 x = dx, y = dy;
+	Uint64 d = (Uint64)(x * x) + (Uint64)(y * y);
+
+	return (fixed_t)SDL_min(isqrt64(d), SDL_MAX_SINT32);
+}
+
+fixed_t fixapproxdist(fixed_t dx, fixed_t dy)
+{
+	dx = SDL_abs(dx);
+	dy = SDL_abs(dy);
+
+	if (dx < dy)
+		return dx + dy - (dx >> 1);
+	else
+		return dx + dy - (dy >> 1);
+}
+
+Vec2x Vec2x_add(Vec2x v1, Vec2x v2)
+{
+	Vec2x result;
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+	return result;
+}
+
+Vec2x Vec2x_sub(Vec2x v1, Vec2x v2)
+{
+	Vec2x result;
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+	return result;
+}
+
+Vec2x Vec2x_scale(Vec2x v, fixed_t s)
+{
+	Vec2x result;
+	result.x = fixmul(v.x, s);
+	result.y = fixmul(v.y, s);
+	return result;
+}
+
+fixed_t Vec2x_dotproduct(Vec2x v1, Vec2x v2)
+{
+	return (fixed_t)(((Sint64)v1.x * v2.x + (Sint64)v1.y * v2.y) >> FRACBITS);
+}
+
+Vec2x Vec2x_rotate(Vec2x v, angle_t angle)
+{
+	fixed_t s = fixsin(angle);
+	fixed_t c = fixcos(angle);
+	Vec2x result;
+	result.x = (fixed_t)(((Sint64)v.x * c - (Sint64)v.y * s) >> FRACBITS);
+	result.y = (fixed_t)(((Sint64)v.x * s + (Sint64)v.y * c) >> FRACBITS);
+	return result;
+}
+
+Vec2x Vec2x_fromangle(angle_t angle)
+{
+	Vec2x result;
+	result.x = fixcos(angle);
+	result.y = fixsin(angle);
+	return result;
+}
+
+Vec3x Vec3x_add(Vec3x v1, Vec3x v2)
+{
+	Vec3x result;
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+	result.z = v1.z + v2.z;
+	return result;
+}
+
+Vec3x Vec3x_sub(Vec3x v1, Vec3x v2)
+{
+	Vec3x result;
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+	result.z = v1.z - v2.z;
+	return result;
+}
+
+Vec3x Vec3x_scale(Vec3x v, fixed_t s)
+{
+	Vec3x result;
+	result.x = fixmul(v.x, s);
+	result.y = fixmul(v.y, s);
+	result.z = fixmul(v.z, s);
+	return result;
+}
+
+fixed_t Vec3x_dotproduct(Vec3x v1, Vec3x v2)
+{
+	Sint64 result = 0;
+	result += (Sint64)v1.x * v2.x;
+	result += (Sint64)v1.y * v2.y;
+	result += (Sint64)v1.z * v2.z;
+	return (fixed_t)(result >> FRACBITS);
+}
+
+Vec3x Vec3x_crossproduct(Vec3x v1, Vec3x v2)
+{
+	Vec3x result;
+	result.x = (fixed_t)(((Sint64)v1.y * v2.z - (Sint64)v1.z * v2.y) >> FRACBITS);
+	result.y = (fixed_t)(((Sint64)v1.z * v2.x - (Sint64)v1.x * v2.z) >> FRACBITS);
+	result.z = (fixed_t)(((Sint64)v1.x * v2.y - (Sint64)v1.y * v2.x) >> FRACBITS);
+	return result;
+}
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _FIXED_H_
+#define _FIXED_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <SDL3/SDL.h>
+
+/*
+ * 16.16 fixed point
+ *
+ * the game simulation runs on these so that it produces the same results on
+ * every machine, which keeps demos in sync. angles use the original game's
+ * scheme of 2048 fine angles per turn, counter-clockwise with 0 facing east.
+ */
+
+typedef Sint32 fixed_t;
+typedef Sint32 angle_t;
+
+#define FRACBITS (16)
+#define FRACUNIT (1 << FRACBITS)
+
+#define FINEANGLES (2048)
+#define FINEMASK (FINEANGLES - 1)
+#define ANG90 (FINEANGLES / 4)
+#define ANG180 (FINEANGLES / 2)
+#define ANG270 (FINEANGLES * 3 / 4)
+
+/* resolution of the atan2 slope table */
+#define SLOPERANGE (2048)
+
+#define INT_TO_FIXED(x) ((fixed_t)(x) << FRACBITS)
+#define FIXED_TO_INT(x) ((x) >> FRACBITS)
+#define FLOAT_TO_FIXED(x) ((fixed_t)((x) * FRACUNIT))
+#define FIXED_TO_FLOAT(x) ((float)(x) / FRACUNIT)
+
+#define DEG_TO_ANGLE(x) ((angle_t)((x) * FINEANGLES / 360) & FINEMASK)
+#define ANGLE_TO_DEG(x) ((x) * 360.0f / FINEANGLES)
+
+/*
+ * raycastlib units, with 1024 units per map tile and 1024 units per turn,
+ * rotating clockwise
+ */
+
+#define FIXED_RCL_SHIFT (6)
+#define FIXED_TO_RCL(x) ((x) >> FIXED_RCL_SHIFT)
+#define RCL_TO_FIXED(x) ((fixed_t)(x) << FIXED_RCL_SHIFT)
+#define ANGLE_TO_RCL(x) ((-(x) & FINEMASK) >> 1)
+
+/*
+ * vectors
+ */
+
+typedef struct Vec2x {
+	fixed_t x, y;
+} Vec2x;
+
+typedef struct Vec3x {
+	fixed_t x, y, z;
+} Vec3x;
+
+/*
+ * scalar
+ */
+
+static inline fixed_t fixmul(fixed_t a, fixed_t b)
+{
+	return (fixed_t)(((Sint64)a * b) >> FRACBITS);
+}
+
+/* saturates instead of overflowing, division by zero gives the largest value */
+static inline fixed_t fixdiv(fixed_t a, fixed_t b)
+{
+	if ((SDL_abs(a) >> 14) >= SDL_abs(b))
+		return (a ^ b) < 0 ? SDL_MIN_SINT32 : SDL_MAX_SINT32;
+
+	return (fixed_t)(((Sint64)a << FRACBITS) / b);
+}
+
+fixed_t fixsin(angle_t angle);
+fixed_t fixcos(angle_t angle);
+
+/* returns the fine angle of the vector x,y */
+angle_t fixatan2(fixed_t y, fixed_t x);
+
+fixed_t fixsqrt(fixed_t x);
+
+/* exact length of dx,dy */
+fixed_t fixhypot(fixed_t dx, fixed_t dy);
+
+/* length of dx,dy without a square root, overestimates by up to 12% */
+fixed_t fixapproxdist(fixed_t dx, fixed_t dy);
+
+/*
+ * vec2
+ */
+
+Vec2x Vec2x_add(Vec2x v1, Vec2x v2);
+Vec2x Vec2x_sub(Vec2x v1, Vec2x v2);
+Vec2x Vec2x_scale(Vec2x v, fixed_t s);
+fixed_t Vec2x_dotproduct(Vec2x v1, Vec2x v2);
+Vec2x Vec2x_rotate(Vec2x v, angle_t angle);
+
+/* unit vector pointing at angle */
+Vec2x Vec2x_fromangle(angle_t angle);
+
+/*
+ * vec3
+ */
+
+Vec3x Vec3x_add(Vec3x v1, Vec3x v2);
+Vec3x Vec3x_sub(Vec3x v1, Vec3x v2);
+Vec3x Vec3x_scale(Vec3x v, fixed_t s);
+fixed_t Vec3x_dotproduct(Vec3x v1, Vec3x v2);
+Vec3x Vec3x_crossproduct(Vec3x v1, Vec3x v2);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _FIXED_H_ */
@@ -0,0 +1,456 @@
+/* generated: finesine[i] = round(sin(i * 2pi / 2048) * 65536) */
+static const fixed_t finesine[FINEANGLES + FINEANGLES / 4] = {
+	0, 201, 402, 603, 804, 1005, 1206, 1407,
+	1608, 1809, 2010, 2211, 2412, 2613, 2814, 3015,
+	3216, 3417, 3617, 3818, 4019, 4219, 4420, 4621,
+	4821, 5022, 5222, 5422, 5623, 5823, 6023, 6224,
+	6424, 6624, 6824, 7024, 7224, 7423, 7623, 7823,
+	8022, 8222, 8421, 8621, 8820, 9019, 9218, 9417,
+	9616, 9815, 10014, 10212, 10411, 10609, 10808, 11006,
+	11204, 11402, 11600, 11798, 11996, 12193, 12391, 12588,
+	12785, 12983, 13180, 13376, 13573, 13770, 13966, 14163,
+	14359, 14555, 14751, 14947, 15143, 15338, 15534, 15729,
+	15924, 16119, 16314, 16508, 16703, 16897, 17091, 17285,
+	17479, 17673, 17867, 18060, 18253, 18446, 18639, 18832,
+	19024, 19216, 19409, 19600, 19792, 19984, 20175, 20366,
+	20557, 20748, 20939, 21129, 21320, 21510, 21699, 21889,
+	22078, 22268, 22457, 22645, 22834, 23022, 23210, 23398,
+	23586, 23774, 23961, 24148, 24335, 24521, 24708, 24894,
+	25080, 25265, 25451, 25636, 25821, 26005, 26190, 26374,
+	26558, 26742, 26925, 27108, 27291, 27474, 27656, 27838,
+	28020, 28202, 28383, 28564, 28745, 28926, 29106, 29286,
+	29466, 29645, 29824, 30003, 30182, 30360, 30538, 30716,
+	30893, 31071, 31248, 31424, 31600, 31776, 31952, 32127,
+	32303, 32477, 32652, 32826, 33000, 33173, 33347, 33520,
+	33692, 33865, 34037, 34208, 34380, 34551, 34721, 34892,
+	35062, 35231, 35401, 35570, 35738, 35907, 36075, 36243,
+	36410, 36577, 36744, 36910, 37076, 37241, 37407, 37572,
+	37736, 37900, 38064, 38228, 38391, 38554, 38716, 38878,
+	39040, 39201, 39362, 39523, 39683, 39843, 40002, 40161,
+	40320, 40478, 40636, 40794, 40951, 41108, 41264, 41420,
+	41576, 41731, 41886, 42040, 42194, 42348, 42501, 42654,
+	42806, 42958, 43110, 43261, 43412, 43562, 43713, 43862,
+	44011, 44160, 44308, 44456, 44604, 44751, 44898, 45044,
+	45190, 45335, 45480, 45625, 45769, 45912, 46056, 46199,
+	46341, 46483, 46624, 46765, 46906, 47046, 47186, 47325,
+	47464, 47603, 47741, 47878, 48015, 48152, 48288, 48424,
+	48559, 48694, 48828, 48962, 49095, 49228, 49361, 49493,
+	49624, 49756, 49886, 50016, 50146, 50275, 50404, 50532,
+	50660, 50787, 50914, 51041, 51166, 51292, 51417, 51541,
+	51665, 51789, 51911, 52034, 52156, 52277, 52398, 52519,
+	52639, 52759, 52878, 52996, 53114, 53232, 53349, 53465,
+	53581, 53697, 53812, 53926, 54040, 54154, 54267, 54379,
+	54491, 54603, 54714, 54824, 54934, 55043, 55152, 55260,
+	55368, 55476, 55582, 55689, 55794, 55900, 56004, 56108,
+	56212, 56315, 56418, 56520, 56621, 56722, 56823, 56923,
+	57022, 57121, 57219, 57317, 57414, 57511, 57607, 57703,
+	57798, 57892, 57986, 58079, 58172, 58265, 58356, 58448,
+	58538, 58628, 58718, 58807, 58896, 58983, 59071, 59158,
+	59244, 59330, 59415, 59499, 59583, 59667, 59750, 59832,
+	59914, 59995, 60075, 60156, 60235, 60314, 60392, 60470,
+	60547, 60624, 60700, 60776, 60851, 60925, 60999, 61072,
+	61145, 61217, 61288, 61359, 61429, 61499, 61568, 61637,
+	61705, 61772, 61839, 61906, 61971, 62036, 62101, 62165,
+	62228, 62291, 62353, 62415, 62476, 62536, 62596, 62655,
+	62714, 62772, 62830, 62886, 62943, 62998, 63054, 63108,
+	63162, 63215, 63268, 63320, 63372, 63423, 63473, 63523,
+	63572, 63621, 63668, 63716, 63763, 63809, 63854, 63899,
+	63944, 63987, 64031, 64073, 64115, 64156, 64197, 64237,
+	64277, 64316, 64354, 64392, 64429, 64465, 64501, 64536,
+	64571, 64605, 64639, 64672, 64704, 64735, 64766, 64797,
+	64827, 64856, 64884, 64912, 64940, 64967, 64993, 65018,
+	65043, 65067, 65091, 65114, 65137, 65159, 65180, 65200,
+	65220, 65240, 65259, 65277, 65294, 65311, 65328, 65343,
+	65358, 65373, 65387, 65400, 65413, 65425, 65436, 65447,
+	65457, 65467, 65476, 65484, 65492, 65499, 65505, 65511,
+	65516, 65521, 65525, 65528, 65531, 65533, 65535, 65536,
+	65536, 65536, 65535, 65533, 65531, 65528, 65525, 65521,
+	65516, 65511, 65505, 65499, 65492, 65484, 65476, 65467,
+	65457, 65447, 65436, 65425, 65413, 65400, 65387, 65373,
+	65358, 65343, 65328, 65311, 65294, 65277, 65259, 65240,
+	65220, 65200, 65180, 65159, 65137, 65114, 65091, 65067,
+	65043, 65018, 64993, 64967, 64940, 64912, 64884, 64856,
+	64827, 64797, 64766, 64735, 64704, 64672, 64639, 64605,
+	64571, 64536, 64501, 64465, 64429, 64392, 64354, 64316,
+	64277, 64237, 64197, 64156, 64115, 64073, 64031, 63987,
+	63944, 63899, 63854, 63809, 63763, 63716, 63668, 63621,
+	63572, 63523, 63473, 63423, 63372, 63320, 63268, 63215,
+	63162, 63108, 63054, 62998, 62943, 62886, 62830, 62772,
+	62714, 62655, 62596, 62536, 62476, 62415, 62353, 62291,
+	62228, 62165, 62101, 62036, 61971, 61906, 61839, 61772,
+	61705, 61637, 61568, 61499, 61429, 61359, 61288, 61217,
+	61145, 61072, 60999, 60925, 60851, 60776, 60700, 60624,
+	60547, 60470, 60392, 60314, 60235, 60156, 60075, 59995,
+	59914, 59832, 59750, 59667, 59583, 59499, 59415, 59330,
+	59244, 59158, 59071, 58983, 58896, 58807, 58718, 58628,
+	58538, 58448, 58356, 58265, 58172, 58079, 57986, 57892,
+	57798, 57703, 57607, 57511, 57414, 57317, 57219, 57121,
+	57022, 56923, 56823, 56722, 56621, 56520, 56418, 56315,
+	56212, 56108, 56004, 55900, 55794, 55689, 55582, 55476,
+	55368, 55260, 55152, 55043, 54934, 54824, 54714, 54603,
+	54491, 54379, 54267, 54154, 54040, 53926, 53812, 53697,
+	53581, 53465, 53349, 53232, 53114, 52996, 52878, 52759,
+	52639, 52519, 52398, 52277, 52156, 52034, 51911, 51789,
+	51665, 51541, 51417, 51292, 51166, 51041, 50914, 50787,
+	50660, 50532, 50404, 50275, 50146, 50016, 49886, 49756,
+	49624, 49493, 49361, 49228, 49095, 48962, 48828, 48694,
+	48559, 48424, 48288, 48152, 48015, 47878, 47741, 47603,
+	47464, 47325, 47186, 47046, 46906, 46765, 46624, 46483,
+	46341, 46199, 46056, 45912, 45769, 45625, 45480, 45335,
+	45190, 45044, 44898, 44751, 44604, 44456, 44308, 44160,
+	44011, 43862, 43713, 43562, 43412, 43261, 43110, 42958,
+	42806, 42654, 42501, 42348, 42194, 42040, 41886, 41731,
+	41576, 41420, 41264, 41108, 40951, 40794, 40636, 40478,
+	40320, 40161, 40002, 39843, 39683, 39523, 39362, 39201,
+	39040, 38878, 38716, 38554, 38391, 38228, 38064, 37900,
+	37736, 37572, 37407, 37241, 37076, 36910, 36744, 36577,
+	36410, 36243, 36075, 35907, 35738, 35570, 35401, 35231,
+	35062, 34892, 34721, 34551, 34380, 34208, 34037, 33865,
+	33692, 33520, 33347, 33173, 33000, 32826, 32652, 32477,
+	32303, 32127, 31952, 31776, 31600, 31424, 31248, 31071,
+	30893, 30716, 30538, 30360, 30182, 30003, 29824, 29645,
+	29466, 29286, 29106, 28926, 28745, 28564, 28383, 28202,
+	28020, 27838, 27656, 27474, 27291, 27108, 26925, 26742,
+	26558, 26374, 26190, 26005, 25821, 25636, 25451, 25265,
+	25080, 24894, 24708, 24521, 24335, 24148, 23961, 23774,
+	23586, 23398, 23210, 23022, 22834, 22645, 22457, 22268,
+	22078, 21889, 21699, 21510, 21320, 21129, 20939, 20748,
+	20557, 20366, 20175, 19984, 19792, 19600, 19409, 19216,
+	19024, 18832, 18639, 18446, 18253, 18060, 17867, 17673,
+	17479, 17285, 17091, 16897, 16703, 16508, 16314, 16119,
+	15924, 15729, 15534, 15338, 15143, 14947, 14751, 14555,
+	14359, 14163, 13966, 13770, 13573, 13376, 13180, 12983,
+	12785, 12588, 12391, 12193, 11996, 11798, 11600, 11402,
+	11204, 11006, 10808, 10609, 10411, 10212, 10014, 9815,
+	9616, 9417, 9218, 9019, 8820, 8621, 8421, 8222,
+	8022, 7823, 7623, 7423, 7224, 7024, 6824, 6624,
+	6424, 6224, 6023, 5823, 5623, 5422, 5222, 5022,
+	4821, 4621, 4420, 4219, 4019, 3818, 3617, 3417,
+	3216, 3015, 2814, 2613, 2412, 2211, 2010, 1809,
+	1608, 1407, 1206, 1005, 804, 603, 402, 201,
+	0, -201, -402, -603, -804, -1005, -1206, -1407,
+	-1608, -1809, -2010, -2211, -2412, -2613, -2814, -3015,
+	-3216, -3417, -3617, -3818, -4019, -4219, -4420, -4621,
+	-4821, -5022, -5222, -5422, -5623, -5823, -6023, -6224,
+	-6424, -6624, -6824, -7024, -7224, -7423, -7623, -7823,
+	-8022, -8222, -8421, -8621, -8820, -9019, -9218, -9417,
+	-9616, -9815, -10014, -10212, -10411, -10609, -10808, -11006,
+	-11204, -11402, -11600, -11798, -11996, -12193, -12391, -12588,
+	-12785, -12983, -13180, -13376, -13573, -13770, -13966, -14163,
+	-14359, -14555, -14751, -14947, -15143, -15338, -15534, -15729,
+	-15924, -16119, -16314, -16508, -16703, -16897, -17091, -17285,
+	-17479, -17673, -17867, -18060, -18253, -18446, -18639, -18832,
+	-19024, -19216, -19409, -19600, -19792, -19984, -20175, -20366,
+	-20557, -20748, -20939, -21129, -21320, -21510, -21699, -21889,
+	-22078, -22268, -22457, -22645, -22834, -23022, -23210, -23398,
+	-23586, -23774, -23961, -24148, -24335, -24521, -24708, -24894,
+	-25080, -25265, -25451, -25636, -25821, -26005, -26190, -26374,
+	-26558, -26742, -26925, -27108, -27291, -27474, -27656, -27838,
+	-28020, -28202, -28383, -28564, -28745, -28926, -29106, -29286,
+	-29466, -29645, -29824, -30003, -30182, -30360, -30538, -30716,
+	-30893, -31071, -31248, -31424, -31600, -31776, -31952, -32127,
+	-32303, -32477, -32652, -32826, -33000, -33173, -33347, -33520,
+	-33692, -33865, -34037, -34208, -34380, -34551, -34721, -34892,
+	-35062, -35231, -35401, -35570, -35738, -35907, -36075, -36243,
+	-36410, -36577, -36744, -36910, -37076, -37241, -37407, -37572,
+	-37736, -37900, -38064, -38228, -38391, -38554, -38716, -38878,
+	-39040, -39201, -39362, -39523, -39683, -39843, -40002, -40161,
+	-40320, -40478, -40636, -40794, -40951, -41108, -41264, -41420,
+	-41576, -41731, -41886, -42040, -42194, -42348, -42501, -42654,
+	-42806, -42958, -43110, -43261, -43412, -43562, -43713, -43862,
+	-44011, -44160, -44308, -44456, -44604, -44751, -44898, -45044,
+	-45190, -45335, -45480, -45625, -45769, -45912, -46056, -46199,
+	-46341, -46483, -46624, -46765, -46906, -47046, -47186, -47325,
+	-47464, -47603, -47741, -47878, -48015, -48152, -48288, -48424,
+	-48559, -48694, -48828, -48962, -49095, -49228, -49361, -49493,
+	-49624, -49756, -49886, -50016, -50146, -50275, -50404, -50532,
+	-50660, -50787, -50914, -51041, -51166, -51292, -51417, -51541,
+	-51665, -51789, -51911, -52034, -52156, -52277, -52398, -52519,
+	-52639, -52759, -52878, -52996, -53114, -53232, -53349, -53465,
+	-53581, -53697, -53812, -53926, -54040, -54154, -54267, -54379,
+	-54491, -54603, -54714, -54824, -54934, -55043, -55152, -55260,
+	-55368, -55476, -55582, -55689, -55794, -55900, -56004, -56108,
+	-56212, -56315, -56418, -56520, -56621, -56722, -56823, -56923,
+	-57022, -57121, -57219, -57317, -57414, -57511, -57607, -57703,
+	-57798, -57892, -57986, -58079, -58172, -58265, -58356, -58448,
+	-58538, -58628, -58718, -58807, -58896, -58983, -59071, -59158,
+	-59244, -59330, -59415, -59499, -59583, -59667, -59750, -59832,
+	-59914, -59995, -60075, -60156, -60235, -60314, -60392, -60470,
+	-60547, -60624, -60700, -60776, -60851, -60925, -60999, -61072,
+	-61145, -61217, -61288, -61359, -61429, -61499, -61568, -61637,
+	-61705, -61772, -61839, -61906, -61971, -62036, -62101, -62165,
+	-62228, -62291, -62353, -62415, -62476, -62536, -62596, -62655,
+	-62714, -62772, -62830, -62886, -62943, -62998, -63054, -63108,
+	-63162, -63215, -63268, -63320, -63372, -63423, -63473, -63523,
+	-63572, -63621, -63668, -63716, -63763, -63809, -63854, -63899,
+	-63944, -63987, -64031, -64073, -64115, -64156, -64197, -64237,
+	-64277, -64316, -64354, -64392, -64429, -64465, -64501, -64536,
+	-64571, -64605, -64639, -64672, -64704, -64735, -64766, -64797,
+	-64827, -64856, -64884, -64912, -64940, -64967, -64993, -65018,
+	-65043, -65067, -65091, -65114, -65137, -65159, -65180, -65200,
+	-65220, -65240, -65259, -65277, -65294, -65311, -65328, -65343,
+	-65358, -65373, -65387, -65400, -65413, -65425, -65436, -65447,
+	-65457, -65467, -65476, -65484, -65492, -65499, -65505, -65511,
+	-65516, -65521, -65525, -65528, -65531, -65533, -65535, -65536,
+	-65536, -65536, -65535, -65533, -65531, -65528, -65525, -65521,
+	-65516, -65511, -65505, -65499, -65492, -65484, -65476, -65467,
+	-65457, -65447, -65436, -65425, -65413, -65400, -65387, -65373,
+	-65358, -65343, -65328, -65311, -65294, -65277, -65259, -65240,
+	-65220, -65200, -65180, -65159, -65137, -65114, -65091, -65067,
+	-65043, -65018, -64993, -64967, -64940, -64912, -64884, -64856,
+	-64827, -64797, -64766, -64735, -64704, -64672, -64639, -64605,
+	-64571, -64536, -64501, -64465, -64429, -64392, -64354, -64316,
+	-64277, -64237, -64197, -64156, -64115, -64073, -64031, -63987,
+	-63944, -63899, -63854, -63809, -63763, -63716, -63668, -63621,
+	-63572, -63523, -63473, -63423, -63372, -63320, -63268, -63215,
+	-63162, -63108, -63054, -62998, -62943, -62886, -62830, -62772,
+	-62714, -62655, -62596, -62536, -62476, -62415, -62353, -62291,
+	-62228, -62165, -62101, -62036, -61971, -61906, -61839, -61772,
+	-61705, -61637, -61568, -61499, -61429, -61359, -61288, -61217,
+	-61145, -61072, -60999, -60925, -60851, -60776, -60700, -60624,
+	-60547, -60470, -60392, -60314, -60235, -60156, -60075, -59995,
+	-59914, -59832, -59750, -59667, -59583, -59499, -59415, -59330,
+	-59244, -59158, -59071, -58983, -58896, -58807, -58718, -58628,
+	-58538, -58448, -58356, -58265, -58172, -58079, -57986, -57892,
+	-57798, -57703, -57607, -57511, -57414, -57317, -57219, -57121,
+	-57022, -56923, -56823, -56722, -56621, -56520, -56418, -56315,
+	-56212, -56108, -56004, -55900, -55794, -55689, -55582, -55476,
+	-55368, -55260, -55152, -55043, -54934, -54824, -54714, -54603,
+	-54491, -54379, -54267, -54154, -54040, -53926, -53812, -53697,
+	-53581, -53465, -53349, -53232, -53114, -52996, -52878, -52759,
+	-52639, -52519, -52398, -52277, -52156, -52034, -51911, -51789,
+	-51665, -51541, -51417, -51292, -51166, -51041, -50914, -50787,
+	-50660, -50532, -50404, -50275, -50146, -50016, -49886, -49756,
+	-49624, -49493, -49361, -49228, -49095, -48962, -48828, -48694,
+	-48559, -48424, -48288, -48152, -48015, -47878, -47741, -47603,
+	-47464, -47325, -47186, -47046, -46906, -46765, -46624, -46483,
+	-46341, -46199, -46056, -45912, -45769, -45625, -45480, -45335,
+	-45190, -45044, -44898, -44751, -44604, -44456, -44308, -44160,
+	-44011, -43862, -43713, -43562, -43412, -43261, -43110, -42958,
+	-42806, -42654, -42501, -42348, -42194, -42040, -41886, -41731,
+	-41576, -41420, -41264, -41108, -40951, -40794, -40636, -40478,
+	-40320, -40161, -40002, -39843, -39683, -39523, -39362, -39201,
+	-39040, -38878, -38716, -38554, -38391, -38228, -38064, -37900,
+	-37736, -37572, -37407, -37241, -37076, -36910, -36744, -36577,
+	-36410, -36243, -36075, -35907, -35738, -35570, -35401, -35231,
+	-35062, -34892, -34721, -34551, -34380, -34208, -34037, -33865,
+	-33692, -33520, -33347, -33173, -33000, -32826, -32652, -32477,
+	-32303, -32127, -31952, -31776, -31600, -31424, -31248, -31071,
+	-30893, -30716, -30538, -30360, -30182, -30003, -29824, -29645,
+	-29466, -29286, -29106, -28926, -28745, -28564, -28383, -28202,
+	-28020, -27838, -27656, -27474, -27291, -27108, -26925, -26742,
+	-26558, -26374, -26190, -26005, -25821, -25636, -25451, -25265,
+	-25080, -24894, -24708, -24521, -24335, -24148, -23961, -23774,
+	-23586, -23398, -23210, -23022, -22834, -22645, -22457, -22268,
+	-22078, -21889, -21699, -21510, -21320, -21129, -20939, -20748,
+	-20557, -20366, -20175, -19984, -19792, -19600, -19409, -19216,
+	-19024, -18832, -18639, -18446, -18253, -18060, -17867, -17673,
+	-17479, -17285, -17091, -16897, -16703, -16508, -16314, -16119,
+	-15924, -15729, -15534, -15338, -15143, -14947, -14751, -14555,
+	-14359, -14163, -13966, -13770, -13573, -13376, -13180, -12983,
+	-12785, -12588, -12391, -12193, -11996, -11798, -11600, -11402,
+	-11204, -11006, -10808, -10609, -10411, -10212, -10014, -9815,
+	-9616, -9417, -9218, -9019, -8820, -8621, -8421, -8222,
+	-8022, -7823, -7623, -7423, -7224, -7024, -6824, -6624,
+	-6424, -6224, -6023, -5823, -5623, -5422, -5222, -5022,
+	-4821, -4621, -4420, -4219, -4019, -3818, -3617, -3417,
+	-3216, -3015, -2814, -2613, -2412, -2211, -2010, -1809,
+	-1608, -1407, -1206, -1005, -804, -603, -402, -201,
+	0, 201, 402, 603, 804, 1005, 1206, 1407,
+	1608, 1809, 2010, 2211, 2412, 2613, 2814, 3015,
+	3216, 3417, 3617, 3818, 4019, 4219, 4420, 4621,
+	4821, 5022, 5222, 5422, 5623, 5823, 6023, 6224,
+	6424, 6624, 6824, 7024, 7224, 7423, 7623, 7823,
+	8022, 8222, 8421, 8621, 8820, 9019, 9218, 9417,
+	9616, 9815, 10014, 10212, 10411, 10609, 10808, 11006,
+	11204, 11402, 11600, 11798, 11996, 12193, 12391, 12588,
+	12785, 12983, 13180, 13376, 13573, 13770, 13966, 14163,
+	14359, 14555, 14751, 14947, 15143, 15338, 15534, 15729,
+	15924, 16119, 16314, 16508, 16703, 16897, 17091, 17285,
+	17479, 17673, 17867, 18060, 18253, 18446, 18639, 18832,
+	19024, 19216, 19409, 19600, 19792, 19984, 20175, 20366,
+	20557, 20748, 20939, 21129, 21320, 21510, 21699, 21889,
+	22078, 22268, 22457, 22645, 22834, 23022, 23210, 23398,
+	23586, 23774, 23961, 24148, 24335, 24521, 24708, 24894,
+	25080, 25265, 25451, 25636, 25821, 26005, 26190, 26374,
+	26558, 26742, 26925, 27108, 27291, 27474, 27656, 27838,
+	28020, 28202, 28383, 28564, 28745, 28926, 29106, 29286,
+	29466, 29645, 29824, 30003, 30182, 30360, 30538, 30716,
+	30893, 31071, 31248, 31424, 31600, 31776, 31952, 32127,
+	32303, 32477, 32652, 32826, 33000, 33173, 33347, 33520,
+	33692, 33865, 34037, 34208, 34380, 34551, 34721, 34892,
+	35062, 35231, 35401, 35570, 35738, 35907, 36075, 36243,
+	36410, 36577, 36744, 36910, 37076, 37241, 37407, 37572,
+	37736, 37900, 38064, 38228, 38391, 38554, 38716, 38878,
+	39040, 39201, 39362, 39523, 39683, 39843, 40002, 40161,
+	40320, 40478, 40636, 40794, 40951, 41108, 41264, 41420,
+	41576, 41731, 41886, 42040, 42194, 42348, 42501, 42654,
+	42806, 42958, 43110, 43261, 43412, 43562, 43713, 43862,
+	44011, 44160, 44308, 44456, 44604, 44751, 44898, 45044,
+	45190, 45335, 45480, 45625, 45769, 45912, 46056, 46199,
+	46341, 46483, 46624, 46765, 46906, 47046, 47186, 47325,
+	47464, 47603, 47741, 47878, 48015, 48152, 48288, 48424,
+	48559, 48694, 48828, 48962, 49095, 49228, 49361, 49493,
+	49624, 49756, 49886, 50016, 50146, 50275, 50404, 50532,
+	50660, 50787, 50914, 51041, 51166, 51292, 51417, 51541,
+	51665, 51789, 51911, 52034, 52156, 52277, 52398, 52519,
+	52639, 52759, 52878, 52996, 53114, 53232, 53349, 53465,
+	53581, 53697, 53812, 53926, 54040, 54154, 54267, 54379,
+	54491, 54603, 54714, 54824, 54934, 55043, 55152, 55260,
+	55368, 55476, 55582, 55689, 55794, 55900, 56004, 56108,
+	56212, 56315, 56418, 56520, 56621, 56722, 56823, 56923,
+	57022, 57121, 57219, 57317, 57414, 57511, 57607, 57703,
+	57798, 57892, 57986, 58079, 58172, 58265, 58356, 58448,
+	58538, 58628, 58718, 58807, 58896, 58983, 59071, 59158,
+	59244, 59330, 59415, 59499, 59583, 59667, 59750, 59832,
+	59914, 59995, 60075, 60156, 60235, 60314, 60392, 60470,
+	60547, 60624, 60700, 60776, 60851, 60925, 60999, 61072,
+	61145, 61217, 61288, 61359, 61429, 61499, 61568, 61637,
+	61705, 61772, 61839, 61906, 61971, 62036, 62101, 62165,
+	62228, 62291, 62353, 62415, 62476, 62536, 62596, 62655,
+	62714, 62772, 62830, 62886, 62943, 62998, 63054, 63108,
+	63162, 63215, 63268, 63320, 63372, 63423, 63473, 63523,
+	63572, 63621, 63668, 63716, 63763, 63809, 63854, 63899,
+	63944, 63987, 64031, 64073, 64115, 64156, 64197, 64237,
+	64277, 64316, 64354, 64392, 64429, 64465, 64501, 64536,
+	64571, 64605, 64639, 64672, 64704, 64735, 64766, 64797,
+	64827, 64856, 64884, 64912, 64940, 64967, 64993, 65018,
+	65043, 65067, 65091, 65114, 65137, 65159, 65180, 65200,
+	65220, 65240, 65259, 65277, 65294, 65311, 65328, 65343,
+	65358, 65373, 65387, 65400, 65413, 65425, 65436, 65447,
+	65457, 65467, 65476, 65484, 65492, 65499, 65505, 65511,
+	65516, 65521, 65525, 65528, 65531, 65533, 65535, 65536
+};
+
+/* generated: tantoangle[i] = round(atan(i / 2048) * 2048 / 2pi) */
+static const angle_t tantoangle[SLOPERANGE + 1] = {
+	0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5,
+	5, 5, 5, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7,
+	8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10,
+	10, 10, 11, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 13,
+	13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15,
+	15, 15, 16, 16, 16, 16, 16, 16, 17, 17, 17, 17, 17, 17, 17, 18,
+	18, 18, 18, 18, 18, 19, 19, 19, 19, 19, 19, 20, 20, 20, 20, 20,
+	20, 21, 21, 21, 21, 21, 21, 21, 22, 22, 22, 22, 22, 22, 23, 23,
+	23, 23, 23, 23, 24, 24, 24, 24, 24, 24, 24, 25, 25, 25, 25, 25,
+	25, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 28, 28,
+	28, 28, 28, 28, 29, 29, 29, 29, 29, 29, 30, 30, 30, 30, 30, 30,
+	30, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 33, 33, 33,
+	33, 33, 33, 33, 34, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35,
+	36, 36, 36, 36, 36, 36, 36, 37, 37, 37, 37, 37, 37, 38, 38, 38,
+	38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40,
+	41, 41, 41, 41, 41, 41, 41, 42, 42, 42, 42, 42, 42, 43, 43, 43,
+	43, 43, 43, 44, 44, 44, 44, 44, 44, 44, 45, 45, 45, 45, 45, 45,
+	46, 46, 46, 46, 46, 46, 46, 47, 47, 47, 47, 47, 47, 48, 48, 48,
+	48, 48, 48, 48, 49, 49, 49, 49, 49, 49, 50, 50, 50, 50, 50, 50,
+	51, 51, 51, 51, 51, 51, 51, 52, 52, 52, 52, 52, 52, 53, 53, 53,
+	53, 53, 53, 53, 54, 54, 54, 54, 54, 54, 55, 55, 55, 55, 55, 55,
+	55, 56, 56, 56, 56, 56, 56, 57, 57, 57, 57, 57, 57, 57, 58, 58,
+	58, 58, 58, 58, 59, 59, 59, 59, 59, 59, 59, 60, 60, 60, 60, 60,
+	60, 61, 61, 61, 61, 61, 61, 61, 62, 62, 62, 62, 62, 62, 63, 63,
+	63, 63, 63, 63, 63, 64, 64, 64, 64, 64, 64, 65, 65, 65, 65, 65,
+	65, 65, 66, 66, 66, 66, 66, 66, 67, 67, 67, 67, 67, 67, 67, 68,
+	68, 68, 68, 68, 68, 69, 69, 69, 69, 69, 69, 69, 70, 70, 70, 70,
+	70, 70, 70, 71, 71, 71, 71, 71, 71, 72, 72, 72, 72, 72, 72, 72,
+	73, 73, 73, 73, 73, 73, 74, 74, 74, 74, 74, 74, 74, 75, 75, 75,
+	75, 75, 75, 75, 76, 76, 76, 76, 76, 76, 77, 77, 77, 77, 77, 77,
+	77, 78, 78, 78, 78, 78, 78, 79, 79, 79, 79, 79, 79, 79, 80, 80,
+	80, 80, 80, 80, 80, 81, 81, 81, 81, 81, 81, 81, 82, 82, 82, 82,
+	82, 82, 83, 83, 83, 83, 83, 83, 83, 84, 84, 84, 84, 84, 84, 84,
+	85, 85, 85, 85, 85, 85, 86, 86, 86, 86, 86, 86, 86, 87, 87, 87,
+	87, 87, 87, 87, 88, 88, 88, 88, 88, 88, 88, 89, 89, 89, 89, 89,
+	89, 90, 90, 90, 90, 90, 90, 90, 91, 91, 91, 91, 91, 91, 91, 92,
+	92, 92, 92, 92, 92, 92, 93, 93, 93, 93, 93, 93, 93, 94, 94, 94,
+	94, 94, 94, 95, 95, 95, 95, 95, 95, 95, 96, 96, 96, 96, 96, 96,
+	96, 97, 97, 97, 97, 97, 97, 97, 98, 98, 98, 98, 98, 98, 98, 99,
+	99, 99, 99, 99, 99, 99, 100, 100, 100, 100, 100, 100, 100, 101, 101, 101,
+	101, 101, 101, 101, 102, 102, 102, 102, 102, 102, 102, 103, 103, 103, 103, 103,
+	103, 103, 104, 104, 104, 104, 104, 104, 104, 105, 105, 105, 105, 105, 105, 105,
+	106, 106, 106, 106, 106, 106, 106, 107, 107, 107, 107, 107, 107, 107, 108, 108,
+	108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109, 109, 110, 110, 110, 110,
+	110, 110, 110, 111, 111, 111, 111, 111, 111, 111, 112, 112, 112, 112, 112, 112,
+	112, 113, 113, 113, 113, 113, 113, 113, 114, 114, 114, 114, 114, 114, 114, 115,
+	115, 115, 115, 115, 115, 115, 116, 116, 116, 116, 116, 116, 116, 117, 117, 117,
+	117, 117, 117, 117, 117, 118, 118, 118, 118, 118, 118, 118, 119, 119, 119, 119,
+	119, 119, 119, 120, 120, 120, 120, 120, 120, 120, 121, 121, 121, 121, 121, 121,
+	121, 122, 122, 122, 122, 122, 122, 122, 122, 123, 123, 123, 123, 123, 123, 123,
+	124, 124, 124, 124, 124, 124, 124, 125, 125, 125, 125, 125, 125, 125, 126, 126,
+	126, 126, 126, 126, 126, 126, 127, 127, 127, 127, 127, 127, 127, 128, 128, 128,
+	128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 129, 130, 130, 130, 130,
+	130, 130, 130, 131, 131, 131, 131, 131, 131, 131, 131, 132, 132, 132, 132, 132,
+	132, 132, 133, 133, 133, 133, 133, 133, 133, 133, 134, 134, 134, 134, 134, 134,
+	134, 135, 135, 135, 135, 135, 135, 135, 135, 136, 136, 136, 136, 136, 136, 136,
+	137, 137, 137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 138, 139,
+	139, 139, 139, 139, 139, 139, 139, 140, 140, 140, 140, 140, 140, 140, 141, 141,
+	141, 141, 141, 141, 141, 141, 142, 142, 142, 142, 142, 142, 142, 142, 143, 143,
+	143, 143, 143, 143, 143, 144, 144, 144, 144, 144, 144, 144, 144, 145, 145, 145,
+	145, 145, 145, 145, 145, 146, 146, 146, 146, 146, 146, 146, 147, 147, 147, 147,
+	147, 147, 147, 147, 148, 148, 148, 148, 148, 148, 148, 148, 149, 149, 149, 149,
+	149, 149, 149, 149, 150, 150, 150, 150, 150, 150, 150, 150, 151, 151, 151, 151,
+	151, 151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 153, 153, 153, 153, 153,
+	153, 153, 153, 154, 154, 154, 154, 154, 154, 154, 154, 155, 155, 155, 155, 155,
+	155, 155, 155, 156, 156, 156, 156, 156, 156, 156, 156, 157, 157, 157, 157, 157,
+	157, 157, 157, 158, 158, 158, 158, 158, 158, 158, 158, 159, 159, 159, 159, 159,
+	159, 159, 159, 160, 160, 160, 160, 160, 160, 160, 160, 161, 161, 161, 161, 161,
+	161, 161, 161, 162, 162, 162, 162, 162, 162, 162, 162, 163, 163, 163, 163, 163,
+	163, 163, 163, 163, 164, 164, 164, 164, 164, 164, 164, 164, 165, 165, 165, 165,
+	165, 165, 165, 165, 166, 166, 166, 166, 166, 166, 166, 166, 167, 167, 167, 167,
+	167, 167, 167, 167, 167, 168, 168, 168, 168, 168, 168, 168, 168, 169, 169, 169,
+	169, 169, 169, 169, 169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 171, 171,
+	171, 171, 171, 171, 171, 171, 172, 172, 172, 172, 172, 172, 172, 172, 173, 173,
+	173, 173, 173, 173, 173, 173, 173, 174, 174, 174, 174, 174, 174, 174, 174, 175,
+	175, 175, 175, 175, 175, 175, 175, 175, 176, 176, 176, 176, 176, 176, 176, 176,
+	177, 177, 177, 177, 177, 177, 177, 177, 177, 178, 178, 178, 178, 178, 178, 178,
+	178, 179, 179, 179, 179, 179, 179, 179, 179, 179, 180, 180, 180, 180, 180, 180,
+	180, 180, 180, 181, 181, 181, 181, 181, 181, 181, 181, 182, 182, 182, 182, 182,
+	182, 182, 182, 182, 183, 183, 183, 183, 183, 183, 183, 183, 183, 184, 184, 184,
+	184, 184, 184, 184, 184, 184, 185, 185, 185, 185, 185, 185, 185, 185, 185, 186,
+	186, 186, 186, 186, 186, 186, 186, 187, 187, 187, 187, 187, 187, 187, 187, 187,
+	188, 188, 188, 188, 188, 188, 188, 188, 188, 189, 189, 189, 189, 189, 189, 189,
+	189, 189, 190, 190, 190, 190, 190, 190, 190, 190, 190, 191, 191, 191, 191, 191,
+	191, 191, 191, 191, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193, 193, 193,
+	193, 193, 193, 193, 193, 193, 193, 194, 194, 194, 194, 194, 194, 194, 194, 194,
+	195, 195, 195, 195, 195, 195, 195, 195, 195, 196, 196, 196, 196, 196, 196, 196,
+	196, 196, 197, 197, 197, 197, 197, 197, 197, 197, 197, 198, 198, 198, 198, 198,
+	198, 198, 198, 198, 198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 200, 200,
+	200, 200, 200, 200, 200, 200, 200, 200, 201, 201, 201, 201, 201, 201, 201, 201,
+	201, 202, 202, 202, 202, 202, 202, 202, 202, 202, 203, 203, 203, 203, 203, 203,
+	203, 203, 203, 203, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 205, 205,
+	205, 205, 205, 205, 205, 205, 205, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+	206, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 208, 208, 208, 208, 208,
+	208, 208, 208, 208, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 210, 210,
+	210, 210, 210, 210, 210, 210, 210, 210, 211, 211, 211, 211, 211, 211, 211, 211,
+	211, 211, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 213, 213, 213, 213,
+	213, 213, 213, 213, 213, 213, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+	215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216, 216, 216,
+	216, 216, 216, 216, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 218, 218,
+	218, 218, 218, 218, 218, 218, 218, 218, 219, 219, 219, 219, 219, 219, 219, 219,
+	219, 219, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 221, 221, 221,
+	221, 221, 221, 221, 221, 221, 221, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+	222, 222, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 224, 224, 224, 224,
+	224, 224, 224, 224, 224, 224, 224, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+	225, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 227, 227, 227, 227,
+	227, 227, 227, 227, 227, 227, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+	228, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 230, 230, 230, 230,
+	230, 230, 230, 230, 230, 230, 230, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+	231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 233, 233, 233,
+	233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, 234, 234, 234,
+	234, 234, 234, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 236, 236,
+	236, 236, 236, 236, 236, 236, 236, 236, 236, 237, 237, 237, 237, 237, 237, 237,
+	237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238,
+	239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 240, 240, 240, 240, 240,
+	240, 240, 240, 240, 240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+	241, 241, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 243, 243,
+	243, 243, 243, 243, 243, 243, 243, 243, 243, 244, 244, 244, 244, 244, 244, 244,
+	244, 244, 244, 244, 244, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+	245, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 247, 247, 247, 247,
+	247, 247, 247, 247, 247, 247, 247, 247, 248, 248, 248, 248, 248, 248, 248, 248,
+	248, 248, 248, 248, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+	250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 251, 251, 251,
+	251, 251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252, 252,
+	252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+	253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 256, 256, 256, 256, 256, 256,
+	256
+};
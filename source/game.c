@@ -0,0 +1,307 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "neurottic.h"
+
+/*
+ *
+ * types & defines
+ *
+ */
+
+#define MAP_SIZE (128)
+
+/* player movement, in tiles and fine angles per tick */
+#define PLAYER_RADIUS (FRACUNIT / 4)
+#define PLAYER_WALK_SPEED (FRACUNIT * 8 / 100)
+#define PLAYER_RUN_SPEED (FRACUNIT * 16 / 100)
+#define PLAYER_WALK_TURN (23)
+#define PLAYER_RUN_TURN (45)
+#define PLAYER_VIEW_HEIGHT (FRACUNIT / 2)
+
+/* actions keys can be bound to */
+enum {
+	ACTION_FORWARD,
+	ACTION_BACK,
+	ACTION_LEFT,
+	ACTION_RIGHT,
+	ACTION_STRAFELEFT,
+	ACTION_STRAFERIGHT,
+	ACTION_RUN,
+	ACTION_USE,
+	NUM_ACTIONS
+};
+
+typedef struct keybind {
+	SDL_Keycode key;
+	int action;
+} keybind_t;
+
+typedef struct player {
+	fixed_t x;
+	fixed_t y;
+	angle_t angle;
+} player_t;
+
+/*
+ *
+ * globals
+ *
+ */
+
+static int gamestate = GAMESTATE_CONSOLE;
+static player_t player;
+static SDL_bool actions[NUM_ACTIONS];
+static Uint8 solid[MAP_SIZE][MAP_SIZE];
+
+static const keybind_t keybinds[] = {
+	{SDLK_W, ACTION_FORWARD},
+	{SDLK_UP, ACTION_FORWARD},
+	{SDLK_S, ACTION_BACK},
+	{SDLK_DOWN, ACTION_BACK},
+	{SDLK_LEFT, ACTION_LEFT},
+	{SDLK_RIGHT, ACTION_RIGHT},
+	{SDLK_A, ACTION_STRAFELEFT},
+	{SDLK_D, ACTION_STRAFERIGHT},
+	{SDLK_LSHIFT, ACTION_RUN},
+	{SDLK_RSHIFT, ACTION_RUN},
+	{SDLK_SPACE, ACTION_USE}
+};
+
+/*
+ *
+ * private
+ *
+ */
+
+/* returns SDL_TRUE if a player at x,y would overlap a wall */
+static SDL_bool Blocked(fixed_t x, fixed_t y)
+{
+	int x1 = FIXED_TO_INT(x - PLAYER_RADIUS);
+	int y1 = FIXED_TO_INT(y - PLAYER_RADIUS);
+	int x2 = FIXED_TO_INT(x + PLAYER_RADIUS);
+	int y2 = FIXED_TO_INT(y + PLAYER_RADIUS);
+
+	for (int ty = y1; ty <= y2; ty++)
+	{
+		for (int tx = x1; tx <= x2; tx++)
+		{
+			if (tx < 0 || ty < 0 || tx >= MAP_SIZE || ty >= MAP_SIZE || solid[ty][tx])
+				return SDL_TRUE;
+		}
+	}
+
+	return SDL_FALSE;
+}
+
+/* move player, sliding along walls */
+static void Move(fixed_t dx, fixed_t dy)
+{
+	if (!Blocked(player.x + dx, player.y))
+		player.x += dx;
+
+	if (!Blocked(player.x, player.y + dy))
+		player.y += dy;
+}
+
+/*
+ *
+ * console
+ *
+ */
+
+static int CMD_Map(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		Console_Printf("Usage: map <number>");
+		return 0;
+	}
+
+	return G_StartMap(SDL_atoi(argv[1]));
+}
+
+/*
+ *
+ * public
+ *
+ */
+
+int G_Init(void)
+{
+	Console_RegisterCommand("map", CMD_Map);
+
+	gamestate = GAMESTATE_CONSOLE;
+	G_ClearInput();
+
+	return 0;
+}
+
+void G_Quit(void)
+{
+	gamestate = GAMESTATE_CONSOLE;
+	SDL_memset(solid, 0, sizeof(solid));
+}
+
+int G_GetGameState(void)
+{
+	return gamestate;
+}
+
+void G_SetGameState(int state)
+{
+	gamestate = state;
+}
+
+int G_StartMap(int map)
+{
+	Uint16 *walls;
+	int x, y, angle;
+
+	if (MS_LoadMap(map) != 0)
+		return -1;
+
+	if (R_NewMap() != 0)
+		return -1;
+
+	/* solid tiles are the ones the renderer draws as walls */
+	walls = MS_GetCurrentMapPlane(0);
+	if (!walls)
+		return LogError("G_StartMap(): Map %d has no wall plane", map);
+
+	for (y = 0; y < MAP_SIZE; y++)
+	{
+		for (x = 0; x < MAP_SIZE; x++)
+			solid[y][x] = DarkWar_GetWallTexture(walls[y * MAP_SIZE + x]) != NULL;
+	}
+
+	/* spawn player */
+	if (MS_FindPlayerStart(&x, &y, &angle) != 0)
+	{
+		x = y = MAP_SIZE / 2;
+		angle = 0;
+	}
+
+	player.x = INT_TO_FIXED(x) + FRACUNIT / 2;
+	player.y = INT_TO_FIXED(y) + FRACUNIT / 2;
+	player.angle = DEG_TO_ANGLE(angle);
+
+	R_SetView(player.x, player.y, PLAYER_VIEW_HEIGHT, player.angle);
+
+	G_ClearInput();
+	gamestate = GAMESTATE_INGAME;
+
+	return Log("Entered map %d \"%s\"", map, MS_GetMapName(map));
+}
+
+void G_Responder(const SDL_Event *event)
+{
+	if (event->type != SDL_EVENT_KEY_DOWN && event->type != SDL_EVENT_KEY_UP)
+		return;
+
+	/* demos replay their own input */
+	if (event->key.repeat || Demo_IsPlaying())
+		return;
+
+	if (Demo_IsRecording())
+		Demo_RecordEvent(event);
+
+	G_SetKey(event->key.key, event->type == SDL_EVENT_KEY_DOWN);
+}
+
+void G_SetKey(SDL_Keycode key, SDL_bool down)
+{
+	for (int i = 0; i < ASIZE(keybinds); i++)
+	{
+		if (keybinds[i].key == key)
+			actions[keybinds[i].action] = down;
+	}
+}
+
+void G_ClearInput(void)
+{
+	SDL_memset(actions, 0, sizeof(actions));
+}
+
+void G_BuildCmd(usercmd_t *cmd)
+{
+	int turn = actions[ACTION_RUN] ? PLAYER_RUN_TURN : PLAYER_WALK_TURN;
+
+	SDL_memset(cmd, 0, sizeof(usercmd_t));
+
+	cmd->forward = (actions[ACTION_FORWARD] - actions[ACTION_BACK]) * 127;
+	cmd->side = (actions[ACTION_STRAFERIGHT] - actions[ACTION_STRAFELEFT]) * 127;
+	cmd->turn = (actions[ACTION_LEFT] - actions[ACTION_RIGHT]) * turn;
+
+	if (actions[ACTION_RUN])
+		cmd->buttons |= BT_RUN;
+	if (actions[ACTION_USE])
+		cmd->buttons |= BT_USE;
+}
+
+void G_Ticker(const usercmd_t *cmd)
+{
+	fixed_t speed = cmd->buttons & BT_RUN ? PLAYER_RUN_SPEED : PLAYER_WALK_SPEED;
+	fixed_t forward = cmd->forward * speed / 127;
+	fixed_t side = cmd->side * speed / 127;
+	fixed_t s, c;
+
+	/* turn */
+	player.angle = (player.angle + cmd->turn) & FINEMASK;
+
+	/* move, y grows southwards on the map */
+	s = fixsin(player.angle);
+	c = fixcos(player.angle);
+	Move(fixmul(c, forward) + fixmul(s, side), fixmul(c, side) - fixmul(s, forward));
+
+	R_SetView(player.x, player.y, PLAYER_VIEW_HEIGHT, player.angle);
+}
+
+void G_Tick(void)
+{
+	PROFILE_FUNCTION();
+
+	usercmd_t cmd;
+
+	if (Demo_IsPlaying())
+	{
+		if (Demo_ReadTick(&cmd) != 0)
+		{
+			Demo_StopPlayback();
+			return;
+		}
+	}
+	else
+	{
+		if (gamestate != GAMESTATE_INGAME)
+			return;
+
+		G_BuildCmd(&cmd);
+
+		if (Demo_IsRecording())
+			Demo_WriteTick(&cmd);
+	}
+
+	G_Ticker(&cmd);
+}
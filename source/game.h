@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _GAME_H_
+#define _GAME_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* current game state enum */
+enum {
+	GAMESTATE_CONSOLE,
+	GAMESTATE_MENU,
+	GAMESTATE_LOADING,
+	GAMESTATE_INGAME,
+};
+
+/* usercmd buttons */
+enum {
+	BT_USE = 1 << 0,
+	BT_RUN = 1 << 1
+};
+
+/* player input for a single tick, derived from the keys held down. turn is
+ * in fine angles */
+typedef struct usercmd {
+	Sint8 forward;
+	Sint8 side;
+	Sint16 turn;
+	Uint8 buttons;
+} usercmd_t;
+
+/* initialize game */
+int G_Init(void);
+
+/* shutdown game */
+void G_Quit(void);
+
+/* get current game state */
+int G_GetGameState(void);
+
+/* set current game state */
+void G_SetGameState(int state);
+
+/* load map and spawn player at its start */
+int G_StartMap(int map);
+
+/* track input events while in game, recording them into a demo */
+void G_Responder(const SDL_Event *event);
+
+/* set key held state, for keys bound to an action */
+void G_SetKey(SDL_Keycode key, SDL_bool down);
+
+/* forget all held keys */
+void G_ClearInput(void);
+
+/* build usercmd from the keys held down */
+void G_BuildCmd(usercmd_t *cmd);
+
+/* run one game tick with usercmd */
+void G_Ticker(const usercmd_t *cmd);
+
+/* run one game tick, taking input from the player or a demo */
+void G_Tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _GAME_H_ */
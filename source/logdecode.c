@@ -0,0 +1,373 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * binary log decoder
+ *
+ * turns a log written by a NEUROTTIC_BINARY_LOG build back into text, in the
+ * same layout as the text log. see logging.h for the file format.
+ *
+ * usage: neurottic_logdecode <file.bin>
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "logging.h"
+
+#define MAX_FORMATS (65536)
+#define MAX_SPEC (64)
+#define MAX_LINE (8192)
+
+static const char *priorities[SDL_NUM_LOG_PRIORITIES] = {
+	[SDL_LOG_PRIORITY_VERBOSE] = "VERBOSE: ",
+	[SDL_LOG_PRIORITY_DEBUG] = "DEBUG: ",
+	[SDL_LOG_PRIORITY_INFO] = "",
+	[SDL_LOG_PRIORITY_WARN] = "WARNING: ",
+	[SDL_LOG_PRIORITY_ERROR] = "ERROR: ",
+	[SDL_LOG_PRIORITY_CRITICAL] = "CRITICAL: "
+};
+
+static char *formats[MAX_FORMATS];
+
+/* read cursor over the argument data of an event */
+typedef struct reader {
+	const Uint8 *p;
+	const Uint8 *end;
+} reader_t;
+
+static int ReadBytes(reader_t *r, void *dst, size_t len)
+{
+	if ((size_t)(r->end - r->p) < len)
+		return -1;
+
+	SDL_memcpy(dst, r->p, len);
+	r->p += len;
+
+	return 0;
+}
+
+static Sint32 ReadInt32(reader_t *r)
+{
+	Sint32 v = 0;
+	ReadBytes(r, &v, sizeof(v));
+	return v;
+}
+
+static Sint64 ReadInt64(reader_t *r)
+{
+	Sint64 v = 0;
+	ReadBytes(r, &v, sizeof(v));
+	return v;
+}
+
+static double ReadDouble(reader_t *r)
+{
+	double v = 0;
+	ReadBytes(r, &v, sizeof(v));
+	return v;
+}
+
+static const char *ReadString(reader_t *r, char *dst, size_t size)
+{
+	Uint16 len = 0;
+
+	ReadBytes(r, &len, sizeof(len));
+	len = SDL_min(len, size - 1);
+	len = SDL_min(len, (size_t)(r->end - r->p));
+
+	SDL_memcpy(dst, r->p, len);
+	dst[len] = '\0';
+	r->p += len;
+
+	return dst;
+}
+
+/* format an event, mirroring the argument encoding in logging.c */
+static void FormatEvent(char *out, size_t size, const char *fmt, reader_t *r)
+{
+	size_t len = 0;
+
+	#define APPEND(...) do { \
+		int n = snprintf(out + len, size - len, __VA_ARGS__); \
+		if (n > 0) len = SDL_min(len + n, size - 1); \
+	} while (0)
+
+	while (*fmt && len < size - 1)
+	{
+		char spec[MAX_SPEC];
+		int spec_len = 0;
+		SDL_bool wide = SDL_FALSE;
+
+		if (*fmt != '%')
+		{
+			out[len++] = *fmt++;
+			continue;
+		}
+
+		fmt++;
+
+		if (*fmt == '%')
+		{
+			out[len++] = *fmt++;
+			continue;
+		}
+
+		spec[spec_len++] = '%';
+
+		/* flags */
+		while (*fmt && SDL_strchr("-+ #0", *fmt) && spec_len < MAX_SPEC - 32)
+			spec[spec_len++] = *fmt++;
+
+		/* width */
+		if (*fmt == '*')
+		{
+			spec_len += snprintf(spec + spec_len, MAX_SPEC - spec_len, "%d", (int)ReadInt32(r));
+			fmt++;
+		}
+		else
+		{
+			while (SDL_isdigit(*fmt) && spec_len < MAX_SPEC - 24)
+				spec[spec_len++] = *fmt++;
+		}
+
+		/* precision */
+		if (*fmt == '.')
+		{
+			spec[spec_len++] = *fmt++;
+			if (*fmt == '*')
+			{
+				spec_len += snprintf(spec + spec_len, MAX_SPEC - spec_len, "%d", (int)ReadInt32(r));
+				fmt++;
+			}
+			else
+			{
+				while (SDL_isdigit(*fmt) && spec_len < MAX_SPEC - 8)
+					spec[spec_len++] = *fmt++;
+			}
+		}
+
+		/* length modifier, only its width matters here */
+		switch (*fmt)
+		{
+			case 'h':
+				if (*++fmt == 'h')
+					fmt++;
+				break;
+			case 'l':
+				wide = SDL_TRUE;
+				if (*++fmt == 'l')
+					fmt++;
+				break;
+			case 'j': case 'z': case 't':
+				wide = SDL_TRUE;
+				fmt++;
+				break;
+			case 'L':
+				wide = SDL_TRUE;
+				fmt++;
+				break;
+		}
+
+		/* conversion */
+		switch (*fmt)
+		{
+			case 'd': case 'i': case 'u': case 'o':
+			case 'x': case 'X': case 'c':
+				if (wide && *fmt != 'c')
+				{
+					spec[spec_len++] = 'l';
+					spec[spec_len++] = 'l';
+					spec[spec_len++] = *fmt;
+					spec[spec_len] = '\0';
+					APPEND(spec, (long long)ReadInt64(r));
+				}
+				else
+				{
+					spec[spec_len++] = *fmt;
+					spec[spec_len] = '\0';
+					APPEND(spec, wide ? (int)ReadInt64(r) : (int)ReadInt32(r));
+				}
+				break;
+
+			case 'f': case 'F': case 'e': case 'E':
+			case 'g': case 'G': case 'a': case 'A':
+				spec[spec_len++] = *fmt;
+				spec[spec_len] = '\0';
+				APPEND(spec, ReadDouble(r));
+				break;
+
+			case 's':
+			{
+				static char s[MAX_LINE];
+				spec[spec_len++] = 's';
+				spec[spec_len] = '\0';
+				APPEND(spec, ReadString(r, s, sizeof(s)));
+				break;
+			}
+
+			case 'p':
+				spec[spec_len++] = 'p';
+				spec[spec_len] = '\0';
+				APPEND(spec, (void *)(uintptr_t)ReadInt64(r));
+				break;
+
+			default:
+				/* not encodable, logging.c stored these as text with format 0 */
+				APPEND("<bad format>");
+				return;
+		}
+
+		fmt++;
+	}
+
+	#undef APPEND
+
+	out[len] = '\0';
+}
+
+int main(int argc, char **argv)
+{
+	size_t size;
+	Uint8 *data;
+	const Uint8 *p, *end;
+	Uint64 frequency = 1;
+	static char line[MAX_LINE];
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <file.bin>\n", argv[0]);
+		return 1;
+	}
+
+	data = SDL_LoadFile(argv[1], &size);
+	if (!data)
+	{
+		fprintf(stderr, "%s: %s\n", argv[1], SDL_GetError());
+		return 1;
+	}
+
+	p = data;
+	end = data + size;
+
+	while (p < end)
+	{
+		reader_t r = {p, end};
+		Uint8 type = 0;
+
+		ReadBytes(&r, &type, sizeof(type));
+
+		if (type == LOG_BINARY_HEADER)
+		{
+			char magic[4];
+			Uint32 version = 0;
+
+			if (ReadBytes(&r, magic, sizeof(magic)) < 0 || SDL_memcmp(magic, LOG_BINARY_MAGIC, 4) != 0)
+			{
+				fprintf(stderr, "%s: bad header at offset %zu\n", argv[1], (size_t)(p - data));
+				break;
+			}
+
+			ReadBytes(&r, &version, sizeof(version));
+			if (version != LOG_BINARY_VERSION)
+			{
+				fprintf(stderr, "%s: unsupported version %u\n", argv[1], version);
+				break;
+			}
+
+			ReadBytes(&r, &frequency, sizeof(frequency));
+			if (!frequency)
+				frequency = 1;
+
+			/* new session, formats are defined again */
+			for (int i = 0; i < MAX_FORMATS; i++)
+			{
+				SDL_free(formats[i]);
+				formats[i] = NULL;
+			}
+		}
+		else if (type == LOG_BINARY_FORMAT)
+		{
+			Uint16 id = 0, len = 0;
+
+			ReadBytes(&r, &id, sizeof(id));
+			ReadBytes(&r, &len, sizeof(len));
+
+			if ((size_t)(r.end - r.p) < len)
+				break;
+
+			SDL_free(formats[id]);
+			formats[id] = SDL_malloc(len + 1);
+			SDL_memcpy(formats[id], r.p, len);
+			formats[id][len] = '\0';
+			r.p += len;
+		}
+		else if (type == LOG_BINARY_EVENT)
+		{
+			Uint16 id = 0, args_size = 0;
+			Uint8 category = 0, priority = 0;
+			Uint32 thread = 0;
+			Uint64 timestamp = 0;
+			reader_t args;
+
+			ReadBytes(&r, &id, sizeof(id));
+			ReadBytes(&r, &category, sizeof(category));
+			ReadBytes(&r, &priority, sizeof(priority));
+			ReadBytes(&r, &thread, sizeof(thread));
+			ReadBytes(&r, &timestamp, sizeof(timestamp));
+			if (ReadBytes(&r, &args_size, sizeof(args_size)) < 0 || (size_t)(r.end - r.p) < args_size)
+				break;
+
+			args.p = r.p;
+			args.end = r.p + args_size;
+			r.p += args_size;
+
+			if (formats[id])
+				FormatEvent(line, sizeof(line), formats[id], &args);
+			else
+				snprintf(line, sizeof(line), "<undefined format %u>", id);
+
+			if (priority >= SDL_NUM_LOG_PRIORITIES)
+				priority = SDL_LOG_PRIORITY_INFO;
+
+			printf("[%09.4f] [%08x] %s%s\n", (double)timestamp / (double)frequency, thread, priorities[priority] ? priorities[priority] : "", line);
+		}
+		else
+		{
+			fprintf(stderr, "%s: bad record type %u at offset %zu\n", argv[1], type, (size_t)(p - data));
+			break;
+		}
+
+		p = r.p;
+	}
+
+	for (int i = 0; i < MAX_FORMATS; i++)
+		SDL_free(formats[i]);
+
+	SDL_free(data);
+
+	return 0;
+}
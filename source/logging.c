@@ -26,51 +26,913 @@ SOFTWARE.
 
 #include <stdio.h>
 
-static SDL_IOStream *log_file = NULL;
+/*
+ * log records are formatted by SDL on the calling thread and pushed into a
+ * bounded lock-free queue. a background thread drains the queue into stdout,
+ * the console and the log file. if the queue is full, the record is dropped
+ * and counted, and the drain thread reports the number of dropped records.
+ */
 
-static void log_func(void *userdata, int category, SDL_LogPriority priority, const char *message)
-{
+#define LOG_QUEUE_SIZE (1024) /* must be a power of two */
+#define LOG_QUEUE_MASK (LOG_QUEUE_SIZE - 1)
+#define LOG_MESSAGE_SIZE (512)
+#define LOG_IDLE_DELAY (2)
+
+typedef struct log_record {
+	SDL_AtomicInt sequence;
+	SDL_LogPriority priority;
 	Uint64 when;
-	double seconds;
-	static const char *priorities[SDL_NUM_LOG_PRIORITIES] = {
-		[SDL_LOG_PRIORITY_VERBOSE] = "VERBOSE: ",
-		[SDL_LOG_PRIORITY_DEBUG] = "DEBUG: ",
-		[SDL_LOG_PRIORITY_INFO] = "",
-		[SDL_LOG_PRIORITY_WARN] = "WARNING: ",
-		[SDL_LOG_PRIORITY_ERROR] = "ERROR: ",
-		[SDL_LOG_PRIORITY_CRITICAL] = "CRITICAL: "
-	};
+	char message[LOG_MESSAGE_SIZE];
+} log_record_t;
 
-	if (priority < SDL_GetLogPriority(category))
-		return;
+/* the drain thread writes to log_file while Logging_Init() may swap it */
+static SDL_IOStream *log_file = NULL;
+static SDL_Mutex *log_file_mutex = NULL;
+
+/* queue */
+static log_record_t queue[LOG_QUEUE_SIZE];
+static SDL_AtomicInt enqueue_pos = {0};
+static SDL_AtomicInt dequeue_pos = {0};
+static SDL_AtomicInt dropped = {0};
+
+/* drain thread */
+static SDL_Thread *log_thread = NULL;
+static SDL_AtomicInt log_thread_running = {0};
+
+static const char *priorities[SDL_NUM_LOG_PRIORITIES] = {
+	[SDL_LOG_PRIORITY_VERBOSE] = "VERBOSE: ",
+	[SDL_LOG_PRIORITY_DEBUG] = "DEBUG: ",
+	[SDL_LOG_PRIORITY_INFO] = "",
+	[SDL_LOG_PRIORITY_WARN] = "WARNING: ",
+	[SDL_LOG_PRIORITY_ERROR] = "ERROR: ",
+	[SDL_LOG_PRIORITY_CRITICAL] = "CRITICAL: "
+};
 
-	when = SDL_GetTicks();
-	seconds = (double)when / 1000.0f;
+/*
+ *
+ * categories
+ *
+ */
+
+SDL_LogPriority log_priorities[LOG_NUM_CATEGORIES] = {
+	[0 ... LOG_NUM_CATEGORIES - 1] = SDL_LOG_PRIORITY_INFO
+};
+
+static const char *category_names[LOG_NUM_CATEGORIES] = {
+	[SDL_LOG_CATEGORY_APPLICATION] = "app",
+	[LOG_CATEGORY_LM] = "lm",
+	[LOG_CATEGORY_MS] = "ms",
+	[LOG_CATEGORY_R] = "r",
+	[LOG_CATEGORY_AU] = "au",
+	[LOG_CATEGORY_CON] = "con"
+};
+
+static const char *priority_names[SDL_NUM_LOG_PRIORITIES + 1] = {
+	[SDL_LOG_PRIORITY_VERBOSE] = "verbose",
+	[SDL_LOG_PRIORITY_DEBUG] = "debug",
+	[SDL_LOG_PRIORITY_INFO] = "info",
+	[SDL_LOG_PRIORITY_WARN] = "warn",
+	[SDL_LOG_PRIORITY_ERROR] = "error",
+	[SDL_LOG_PRIORITY_CRITICAL] = "critical",
+	[SDL_NUM_LOG_PRIORITIES] = "off"
+};
+
+static int ratelimit_max = LOG_RATELIMIT_DEFAULT;
+
+/* call sites that have suppressed messages, summarized by the drain thread */
+static log_ratelimit_t *ratelimit_sites[LOG_RATELIMIT_MAX_SITES];
+static SDL_AtomicInt num_ratelimit_sites = {0};
+static Uint64 ratelimit_last_summary = 0;
+
+/* write a record to all outputs */
+static void write_record(SDL_LogPriority priority, Uint64 when, const char *message)
+{
+	double seconds = (double)when / 1000.0f;
 
 	fprintf(stdout, "[%09.4f] %s%s\n", seconds, priorities[priority], message);
 
 	Console_Print(message);
 
-	if (userdata)
-		SDL_IOprintf((SDL_IOStream *)userdata, "[%09.4f] %s%s\n", seconds, priorities[priority], message);
+	SDL_LockMutex(log_file_mutex);
+	if (log_file)
+		SDL_IOprintf(log_file, "[%09.4f] %s%s\n", seconds, priorities[priority], message);
+	SDL_UnlockMutex(log_file_mutex);
+}
+
+/* push a record onto the queue, returns SDL_FALSE if the queue is full */
+static SDL_bool enqueue_record(SDL_LogPriority priority, const char *message)
+{
+	log_record_t *record;
+	int pos = SDL_AtomicGet(&enqueue_pos);
+
+	/* claim a slot */
+	for (;;)
+	{
+		int diff;
+
+		record = &queue[pos & LOG_QUEUE_MASK];
+		diff = (int)((unsigned int)SDL_AtomicGet(&record->sequence) - (unsigned int)pos);
+
+		if (diff == 0)
+		{
+			if (SDL_AtomicCompareAndSwap(&enqueue_pos, pos, pos + 1))
+				break;
+		}
+		else if (diff < 0)
+		{
+			/* the drain thread hasn't freed this slot yet */
+			return SDL_FALSE;
+		}
+
+		pos = SDL_AtomicGet(&enqueue_pos);
+	}
+
+	/* fill and publish it */
+	record->priority = priority;
+	record->when = SDL_GetTicks();
+	SDL_strlcpy(record->message, message, sizeof(record->message));
+
+	SDL_AtomicSet(&record->sequence, pos + 1);
+
+	return SDL_TRUE;
+}
+
+/* write out all queued records, returns number of records written */
+static int drain_queue(void)
+{
+	int count = 0;
+	int num_dropped;
+
+	for (;;)
+	{
+		int pos = SDL_AtomicGet(&dequeue_pos);
+		log_record_t *record = &queue[pos & LOG_QUEUE_MASK];
+		int diff = (int)((unsigned int)SDL_AtomicGet(&record->sequence) - (unsigned int)(pos + 1));
+
+		/* nothing published here yet */
+		if (diff < 0)
+			break;
+
+		write_record(record->priority, record->when, record->message);
+
+		/* hand the slot back to the producers */
+		SDL_AtomicSet(&record->sequence, pos + LOG_QUEUE_SIZE);
+		SDL_AtomicSet(&dequeue_pos, pos + 1);
+
+		count++;
+	}
+
+	num_dropped = SDL_AtomicSet(&dropped, 0);
+	if (num_dropped > 0)
+	{
+		char message[64];
+		SDL_snprintf(message, sizeof(message), "Dropped %d log messages", num_dropped);
+		write_record(SDL_LOG_PRIORITY_WARN, SDL_GetTicks(), message);
+	}
+
+	return count;
+}
+
+#ifdef NEUROTTIC_BINARY_LOG
+
+/*
+ *
+ * binary log
+ *
+ */
+
+#define BINLOG_BUFFER_SIZE (65536)
+#define BINLOG_MAX_FORMATS (4096) /* must be a power of two */
+#define BINLOG_MAX_RECORD (4096)
+#define BINLOG_MAX_EVENT (LOG_MESSAGE_SIZE)
+#define BINLOG_FLUSH_INTERVAL (1000)
+#define BINLOG_QUEUE_SIZE (1024) /* must be a power of two */
+#define BINLOG_QUEUE_MASK (BINLOG_QUEUE_SIZE - 1)
+
+/* a call site caches its format as session << BINLOG_SESSION_SHIFT | id */
+#define BINLOG_SESSION_SHIFT (12)
+#define BINLOG_SESSION_MASK ((1 << (31 - BINLOG_SESSION_SHIFT)) - 1)
+
+/* how an argument is read from the va_list */
+typedef enum binlog_arg {
+	BINLOG_ARG_INT,
+	BINLOG_ARG_LONG,
+	BINLOG_ARG_LONGLONG,
+	BINLOG_ARG_SIZE,
+	BINLOG_ARG_INTMAX,
+	BINLOG_ARG_PTRDIFF,
+	BINLOG_ARG_DOUBLE,
+	BINLOG_ARG_LONGDOUBLE,
+	BINLOG_ARG_STRING,
+	BINLOG_ARG_POINTER
+} binlog_arg_t;
+
+typedef struct binlog_format {
+	char *fmt;
+	Uint32 hash;
+	Uint16 id;
+	Uint8 num_args;
+	Uint8 args[LOG_BINARY_MAX_ARGS];
+} binlog_format_t;
+
+/* an encoded event waiting for the drain thread */
+typedef struct binlog_slot {
+	SDL_AtomicInt sequence;
+	Uint16 len;
+	Uint8 data[BINLOG_MAX_EVENT];
+} binlog_slot_t;
+
+/* everything but the queue, the session and the active flag is guarded by binlog_mutex */
+static SDL_IOStream *binlog_file = NULL;
+static SDL_Mutex *binlog_mutex = NULL;
+static SDL_AtomicInt binlog_session = {0};
+static SDL_AtomicInt binlog_active = {0};
+static Uint8 binlog_buffer[BINLOG_BUFFER_SIZE];
+static size_t binlog_len = 0;
+static Uint64 binlog_last_flush = 0;
+static Uint64 binlog_start = 0;
+static binlog_format_t binlog_formats[BINLOG_MAX_FORMATS];
+static binlog_format_t *binlog_format_ids[BINLOG_MAX_FORMATS];
+static int binlog_num_formats = 0;
+
+/* queue, same scheme as the text queue */
+static binlog_slot_t binlog_queue[BINLOG_QUEUE_SIZE];
+static SDL_AtomicInt binlog_enqueue_pos = {0};
+static SDL_AtomicInt binlog_dequeue_pos = {0};
+
+#define PUT(p, v) (SDL_memcpy((p), &(v), sizeof(v)), (p) += sizeof(v))
+
+/* write out buffered records, must hold binlog_mutex */
+static void binlog_flush(void)
+{
+	if (binlog_file && binlog_len)
+		SDL_WriteIO(binlog_file, binlog_buffer, binlog_len);
+
+	binlog_len = 0;
+	binlog_last_flush = SDL_GetTicks();
+}
+
+/* buffer record, must hold binlog_mutex */
+static void binlog_write(const void *data, size_t len)
+{
+	if (binlog_len + len > sizeof(binlog_buffer))
+		binlog_flush();
+
+	SDL_memcpy(binlog_buffer + binlog_len, data, len);
+	binlog_len += len;
+}
+
+static void binlog_write_format(Uint16 id, const char *fmt)
+{
+	Uint8 record[BINLOG_MAX_RECORD];
+	Uint8 *p = record;
+	Uint8 type = LOG_BINARY_FORMAT;
+	Uint16 len = SDL_min(SDL_strlen(fmt), sizeof(record) - 5);
+
+	PUT(p, type);
+	PUT(p, id);
+	PUT(p, len);
+	SDL_memcpy(p, fmt, len);
+	p += len;
+
+	binlog_write(record, p - record);
+}
+
+static void binlog_write_header(void)
+{
+	Uint8 record[32];
+	Uint8 *p = record;
+	Uint8 type = LOG_BINARY_HEADER;
+	Uint32 version = LOG_BINARY_VERSION;
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+
+	PUT(p, type);
+	SDL_memcpy(p, LOG_BINARY_MAGIC, 4);
+	p += 4;
+	PUT(p, version);
+	PUT(p, frequency);
+
+	binlog_write(record, p - record);
+
+	/* fallback format */
+	binlog_write_format(0, "%s");
+}
+
+/* get argument kinds of a printf format string, or -1 if it can't be encoded */
+static int binlog_parse_format(const char *fmt, Uint8 *args)
+{
+	int num_args = 0;
+
+	while (*fmt)
+	{
+		binlog_arg_t length = BINLOG_ARG_INT;
+
+		if (*fmt++ != '%')
+			continue;
+
+		if (*fmt == '%')
+		{
+			fmt++;
+			continue;
+		}
+
+		/* flags */
+		while (*fmt && SDL_strchr("-+ #0", *fmt))
+			fmt++;
+
+		/* width */
+		if (*fmt == '*')
+		{
+			if (num_args >= LOG_BINARY_MAX_ARGS)
+				return -1;
+			args[num_args++] = BINLOG_ARG_INT;
+			fmt++;
+		}
+		else
+		{
+			while (SDL_isdigit(*fmt))
+				fmt++;
+		}
+
+		/* precision */
+		if (*fmt == '.')
+		{
+			fmt++;
+			if (*fmt == '*')
+			{
+				if (num_args >= LOG_BINARY_MAX_ARGS)
+					return -1;
+				args[num_args++] = BINLOG_ARG_INT;
+				fmt++;
+			}
+			else
+			{
+				while (SDL_isdigit(*fmt))
+					fmt++;
+			}
+		}
+
+		/* length modifier */
+		switch (*fmt)
+		{
+			case 'h':
+				if (*++fmt == 'h')
+					fmt++;
+				break;
+			case 'l':
+				length = BINLOG_ARG_LONG;
+				if (*++fmt == 'l')
+				{
+					length = BINLOG_ARG_LONGLONG;
+					fmt++;
+				}
+				break;
+			case 'j':
+				length = BINLOG_ARG_INTMAX;
+				fmt++;
+				break;
+			case 'z':
+				length = BINLOG_ARG_SIZE;
+				fmt++;
+				break;
+			case 't':
+				length = BINLOG_ARG_PTRDIFF;
+				fmt++;
+				break;
+			case 'L':
+				length = BINLOG_ARG_LONGDOUBLE;
+				fmt++;
+				break;
+		}
+
+		if (num_args >= LOG_BINARY_MAX_ARGS)
+			return -1;
+
+		/* conversion */
+		switch (*fmt++)
+		{
+			case 'd': case 'i': case 'u': case 'o':
+			case 'x': case 'X': case 'c':
+				args[num_args++] = length == BINLOG_ARG_LONGDOUBLE ? BINLOG_ARG_LONGLONG : length;
+				break;
+			case 'f': case 'F': case 'e': case 'E':
+			case 'g': case 'G': case 'a': case 'A':
+				args[num_args++] = length == BINLOG_ARG_LONGDOUBLE ? BINLOG_ARG_LONGDOUBLE : BINLOG_ARG_DOUBLE;
+				break;
+			case 's':
+				args[num_args++] = BINLOG_ARG_STRING;
+				break;
+			case 'p':
+				args[num_args++] = BINLOG_ARG_POINTER;
+				break;
+			default:
+				return -1;
+		}
+	}
+
+	return num_args;
+}
+
+/* find or define format, must hold binlog_mutex */
+static binlog_format_t *binlog_find_format(const char *fmt)
+{
+	Uint32 hash = 2166136261u;
+	binlog_format_t *format;
+	int num_args;
+	Uint8 args[LOG_BINARY_MAX_ARGS];
+
+	for (const char *p = fmt; *p; p++)
+		hash = (hash ^ (Uint8)*p) * 16777619u;
+
+	for (int i = hash & (BINLOG_MAX_FORMATS - 1);; i = (i + 1) & (BINLOG_MAX_FORMATS - 1))
+	{
+		format = &binlog_formats[i];
+
+		if (!format->fmt)
+			break;
+
+		if (format->hash == hash && SDL_strcmp(format->fmt, fmt) == 0)
+			return format;
+	}
+
+	/* keep the table at most 3/4 full */
+	if (binlog_num_formats >= BINLOG_MAX_FORMATS * 3 / 4)
+		return NULL;
+
+	if ((num_args = binlog_parse_format(fmt, args)) < 0)
+		return NULL;
+
+	if (!(format->fmt = SDL_strdup(fmt)))
+		return NULL;
+
+	format->hash = hash;
+	format->id = ++binlog_num_formats;
+	format->num_args = num_args;
+	SDL_memcpy(format->args, args, sizeof(args));
+	binlog_format_ids[format->id] = format;
+
+	binlog_write_format(format->id, format->fmt);
+
+	return format;
+}
+
+static void binlog_free_formats(void)
+{
+	for (int i = 0; i < BINLOG_MAX_FORMATS; i++)
+	{
+		if (binlog_formats[i].fmt)
+			SDL_free(binlog_formats[i].fmt);
+	}
+
+	SDL_memset(binlog_formats, 0, sizeof(binlog_formats));
+	SDL_memset(binlog_format_ids, 0, sizeof(binlog_format_ids));
+	binlog_num_formats = 0;
+}
+
+/* start a new session, invalidating the formats cached by call sites */
+static void binlog_next_session(void)
+{
+	int session = (SDL_AtomicGet(&binlog_session) + 1) & BINLOG_SESSION_MASK;
+
+	/* a call site that never logged caches 0 */
+	SDL_AtomicSet(&binlog_session, session ? session : 1);
+}
+
+/* get the format of a call site, looking it up once per session */
+static binlog_format_t *binlog_site_format(log_binary_site_t *site, const char *fmt)
+{
+	binlog_format_t *format = NULL;
+	int session = SDL_AtomicGet(&binlog_session);
+
+	if (site)
+	{
+		int cached = SDL_AtomicGet(&site->format);
+
+		/* formats are only freed when the session changes */
+		if ((cached >> BINLOG_SESSION_SHIFT) == session)
+			return binlog_format_ids[cached & (BINLOG_MAX_FORMATS - 1)];
+	}
+
+	SDL_LockMutex(binlog_mutex);
+	if (binlog_file && SDL_AtomicGet(&binlog_session) == session)
+		format = binlog_find_format(fmt);
+	SDL_UnlockMutex(binlog_mutex);
+
+	if (site && format)
+		SDL_AtomicSet(&site->format, (session << BINLOG_SESSION_SHIFT) | format->id);
+
+	return format;
+}
+
+/* push an encoded event onto the queue, returns SDL_FALSE if the queue is full */
+static SDL_bool binlog_enqueue(const Uint8 *data, size_t len)
+{
+	binlog_slot_t *slot;
+	int pos = SDL_AtomicGet(&binlog_enqueue_pos);
+
+	/* claim a slot */
+	for (;;)
+	{
+		int diff;
+
+		slot = &binlog_queue[pos & BINLOG_QUEUE_MASK];
+		diff = (int)((unsigned int)SDL_AtomicGet(&slot->sequence) - (unsigned int)pos);
+
+		if (diff == 0)
+		{
+			if (SDL_AtomicCompareAndSwap(&binlog_enqueue_pos, pos, pos + 1))
+				break;
+		}
+		else if (diff < 0)
+		{
+			/* the drain thread hasn't freed this slot yet */
+			return SDL_FALSE;
+		}
+
+		pos = SDL_AtomicGet(&binlog_enqueue_pos);
+	}
+
+	/* fill and publish it */
+	slot->len = len;
+	SDL_memcpy(slot->data, data, len);
+
+	SDL_AtomicSet(&slot->sequence, pos + 1);
+
+	return SDL_TRUE;
+}
+
+/* write out all queued events, returns number of events written */
+static int binlog_drain(void)
+{
+	int count = 0;
+
+	SDL_LockMutex(binlog_mutex);
+
+	for (;;)
+	{
+		int pos = SDL_AtomicGet(&binlog_dequeue_pos);
+		binlog_slot_t *slot = &binlog_queue[pos & BINLOG_QUEUE_MASK];
+		int diff = (int)((unsigned int)SDL_AtomicGet(&slot->sequence) - (unsigned int)(pos + 1));
+
+		/* nothing published here yet */
+		if (diff < 0)
+			break;
+
+		if (binlog_file)
+			binlog_write(slot->data, slot->len);
+
+		/* hand the slot back to the producers */
+		SDL_AtomicSet(&slot->sequence, pos + BINLOG_QUEUE_SIZE);
+		SDL_AtomicSet(&binlog_dequeue_pos, pos + 1);
+
+		count++;
+	}
+
+	SDL_UnlockMutex(binlog_mutex);
+
+	return count;
+}
+
+static Uint8 *binlog_put_string(Uint8 *p, Uint8 *end, const char *s)
+{
+	Uint16 len;
+
+	if (!s)
+		s = "(null)";
+
+	len = SDL_min(SDL_strlen(s), (size_t)(end - p) - sizeof(len));
+
+	PUT(p, len);
+	SDL_memcpy(p, s, len);
+
+	return p + len;
+}
+
+static void binlog_event(log_binary_site_t *site, int category, SDL_LogPriority priority, const char *fmt, va_list ap)
+{
+	Uint8 record[BINLOG_MAX_EVENT];
+	Uint8 *p = record;
+	Uint8 *args, *end = record + sizeof(record);
+	binlog_format_t *format;
+	Uint8 type = LOG_BINARY_EVENT;
+	Uint16 id = 0;
+	Uint8 category8 = category;
+	Uint8 priority8 = priority;
+	Uint32 thread = SDL_GetCurrentThreadID();
+	Uint64 timestamp = SDL_GetPerformanceCounter() - binlog_start;
+	Uint16 size = 0;
+
+	format = binlog_site_format(site, fmt);
+	if (format)
+		id = format->id;
+
+	PUT(p, type);
+	PUT(p, id);
+	PUT(p, category8);
+	PUT(p, priority8);
+	PUT(p, thread);
+	PUT(p, timestamp);
+	PUT(p, size);
+
+	args = p;
+
+	if (format)
+	{
+		for (int i = 0; i < format->num_args; i++)
+		{
+			int v_int;
+			Sint64 v_int64;
+			double v_double;
+
+			/* leave room for the biggest fixed size argument */
+			if (end - p < 8)
+				break;
+
+			switch (format->args[i])
+			{
+				case BINLOG_ARG_INT: v_int = va_arg(ap, int); PUT(p, v_int); break;
+				case BINLOG_ARG_LONG: v_int64 = va_arg(ap, long); PUT(p, v_int64); break;
+				case BINLOG_ARG_LONGLONG: v_int64 = va_arg(ap, long long); PUT(p, v_int64); break;
+				case BINLOG_ARG_SIZE: v_int64 = va_arg(ap, size_t); PUT(p, v_int64); break;
+				case BINLOG_ARG_INTMAX: v_int64 = va_arg(ap, intmax_t); PUT(p, v_int64); break;
+				case BINLOG_ARG_PTRDIFF: v_int64 = va_arg(ap, ptrdiff_t); PUT(p, v_int64); break;
+				case BINLOG_ARG_DOUBLE: v_double = va_arg(ap, double); PUT(p, v_double); break;
+				case BINLOG_ARG_LONGDOUBLE: v_double = va_arg(ap, long double); PUT(p, v_double); break;
+				case BINLOG_ARG_POINTER: v_int64 = (uintptr_t)va_arg(ap, void *); PUT(p, v_int64); break;
+				case BINLOG_ARG_STRING: p = binlog_put_string(p, end, va_arg(ap, const char *)); break;
+			}
+		}
+	}
+	else
+	{
+		/* couldn't encode the format, store it as text */
+		char text[BINLOG_MAX_EVENT];
+		SDL_vsnprintf(text, sizeof(text), fmt, ap);
+		p = binlog_put_string(p, end, text);
+	}
+
+	/* patch in argument size */
+	size = p - args;
+	SDL_memcpy(args - sizeof(size), &size, sizeof(size));
+
+	if (!binlog_enqueue(record, p - record))
+		SDL_AtomicAdd(&dropped, 1);
+}
+
+static void binlog_open(const char *filename, SDL_bool append)
+{
+	char path[1024];
+
+	SDL_snprintf(path, sizeof(path), "%s.bin", filename);
+
+	if (!binlog_mutex)
+		binlog_mutex = SDL_CreateMutex();
+
+	/* queued events belong to the old file */
+	binlog_drain();
+
+	SDL_LockMutex(binlog_mutex);
+
+	if (binlog_file)
+	{
+		binlog_flush();
+		SDL_CloseIO(binlog_file);
+	}
+
+	binlog_file = SDL_IOFromFile(path, append ? "ab" : "wb");
+
+	/* formats are defined again for every session */
+	binlog_free_formats();
+	binlog_next_session();
+	binlog_len = 0;
+	binlog_start = SDL_GetPerformanceCounter();
+
+	if (binlog_file)
+		binlog_write_header();
+
+	SDL_AtomicSet(&binlog_active, binlog_file != NULL);
+
+	SDL_UnlockMutex(binlog_mutex);
+
+	if (!binlog_file)
+		LogWarning("Logging_Init(): Unable to open binary log file \"%s\" for writing", path);
+}
+
+static void binlog_close(void)
+{
+	SDL_AtomicSet(&binlog_active, 0);
+	binlog_drain();
+
+	SDL_LockMutex(binlog_mutex);
+	binlog_flush();
+	if (binlog_file) SDL_CloseIO(binlog_file);
+	binlog_file = NULL;
+	binlog_free_formats();
+	binlog_next_session();
+	SDL_UnlockMutex(binlog_mutex);
+
+	SDL_DestroyMutex(binlog_mutex);
+	binlog_mutex = NULL;
+}
+
+/* flush from the logging thread every so often */
+static void binlog_idle(void)
+{
+	if (!SDL_AtomicGet(&binlog_active))
+		return;
+
+	SDL_LockMutex(binlog_mutex);
+	if (SDL_GetTicks() - binlog_last_flush >= BINLOG_FLUSH_INTERVAL)
+		binlog_flush();
+	SDL_UnlockMutex(binlog_mutex);
+}
+
+void Logging_Binary(log_binary_site_t *site, int category, SDL_LogPriority priority, const char *fmt, ...)
+{
+	va_list ap;
+	SDL_bool active;
+
+	if (category < LOG_NUM_CATEGORIES && priority < log_priorities[category])
+		return;
+
+	active = SDL_AtomicGet(&binlog_active);
+
+	va_start(ap, fmt);
+
+	/* warnings and up still go to the text outputs, as does everything
+	 * logged before the binary log is opened */
+	if (!active || priority >= SDL_LOG_PRIORITY_WARN)
+	{
+		va_list text_ap;
+		va_copy(text_ap, ap);
+		SDL_LogMessageV(category, priority, fmt, text_ap);
+		va_end(text_ap);
+	}
+
+	if (active)
+	{
+		binlog_event(site, category, priority, fmt, ap);
+
+		/* no drain thread, write it out here */
+		if (!log_thread)
+			binlog_drain();
+	}
+
+	va_end(ap);
+}
+
+#endif /* NEUROTTIC_BINARY_LOG */
+
+/* log how many messages a call site suppressed since the last summary */
+static void summarize_ratelimit(log_ratelimit_t *ratelimit)
+{
+	int suppressed = SDL_AtomicSet(&ratelimit->suppressed, 0);
+
+	if (suppressed > 0)
+		LOG_OUTPUT(ratelimit->category, ratelimit->priority, "Suppressed %d messages from %s:%d", suppressed, ratelimit->file, ratelimit->line);
+}
+
+/* summarize every call site that went quiet, once per interval or when forced */
+static void summarize_ratelimits(SDL_bool force)
+{
+	int num_sites;
+	Uint64 now = SDL_GetTicks();
+
+	if (!force && now - ratelimit_last_summary < LOG_RATELIMIT_INTERVAL)
+		return;
+
+	ratelimit_last_summary = now;
+
+	num_sites = SDL_min(SDL_AtomicGet(&num_ratelimit_sites), LOG_RATELIMIT_MAX_SITES);
+	for (int i = 0; i < num_sites; i++)
+	{
+		/* claimed, but not stored yet */
+		log_ratelimit_t *ratelimit = SDL_AtomicGetPtr((void **)&ratelimit_sites[i]);
+		if (ratelimit)
+			summarize_ratelimit(ratelimit);
+	}
+}
+
+static int log_thread_func(void *data)
+{
+	while (SDL_AtomicGet(&log_thread_running))
+	{
+		int count;
+
+		summarize_ratelimits(SDL_FALSE);
+
+		count = drain_queue();
+#ifdef NEUROTTIC_BINARY_LOG
+		count += binlog_drain();
+#endif
+
+		if (count == 0)
+		{
+#ifdef NEUROTTIC_BINARY_LOG
+			binlog_idle();
+#endif
+			SDL_Delay(LOG_IDLE_DELAY);
+		}
+	}
+
+	/* pick up whatever came in while shutting down */
+	summarize_ratelimits(SDL_TRUE);
+	drain_queue();
+#ifdef NEUROTTIC_BINARY_LOG
+	binlog_drain();
+#endif
+
+	return 0;
+}
+
+static void log_func(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+	if (priority < SDL_GetLogPriority(category))
+		return;
+
+	/* no drain thread, write it out here */
+	if (!log_thread)
+	{
+		write_record(priority, SDL_GetTicks(), message);
+		return;
+	}
+
+	if (!enqueue_record(priority, message))
+		SDL_AtomicAdd(&dropped, 1);
 }
 
 int Logging_Init(const char *filename, SDL_bool append)
 {
+	/* setup queue */
+	if (!log_thread)
+	{
+		/* sdl filters messages before they reach us */
+		for (int i = 0; i < LOG_NUM_CATEGORIES; i++)
+		{
+			if (category_names[i])
+				SDL_SetLogPriority(i, log_priorities[i]);
+		}
+
+		for (int i = 0; i < LOG_QUEUE_SIZE; i++)
+			SDL_AtomicSet(&queue[i].sequence, i);
+
+		SDL_AtomicSet(&enqueue_pos, 0);
+		SDL_AtomicSet(&dequeue_pos, 0);
+		SDL_AtomicSet(&dropped, 0);
+
+#ifdef NEUROTTIC_BINARY_LOG
+		for (int i = 0; i < BINLOG_QUEUE_SIZE; i++)
+			SDL_AtomicSet(&binlog_queue[i].sequence, i);
+
+		SDL_AtomicSet(&binlog_enqueue_pos, 0);
+		SDL_AtomicSet(&binlog_dequeue_pos, 0);
+#endif
+	}
+
+	if (!log_file_mutex)
+		log_file_mutex = SDL_CreateMutex();
+
 	if (filename)
 	{
+		SDL_IOStream *file;
+
 		if (log_file)
 		{
 			LogWarning("Logging_Init(): Closing existing log file");
-			SDL_CloseIO(log_file);
+			Logging_Flush();
 		}
 
-		log_file = SDL_IOFromFile(filename, append ? "ab" : "wb");
-		if (!log_file)
+		file = SDL_IOFromFile(filename, append ? "ab" : "wb");
+
+		/* the drain thread may be writing a record right now */
+		SDL_LockMutex(log_file_mutex);
+		if (log_file)
+			SDL_CloseIO(log_file);
+		log_file = file;
+		SDL_UnlockMutex(log_file_mutex);
+
+		if (!file)
 			LogWarning("Logging_Init(): Unable to open log file \"%s\" for writing", filename);
+
+#ifdef NEUROTTIC_BINARY_LOG
+		binlog_open(filename, append);
+#endif
+	}
+
+	SDL_SetLogOutputFunction(log_func, NULL);
+
+	/* start drain thread */
+	if (!log_thread)
+	{
+		SDL_AtomicSet(&log_thread_running, 1);
+		log_thread = SDL_CreateThread(log_thread_func, "logging", NULL);
+		if (!log_thread)
+		{
+			SDL_AtomicSet(&log_thread_running, 0);
+			LogWarning("Logging_Init(): Failed to start logging thread, logging synchronously");
+		}
 	}
 
-	SDL_SetLogOutputFunction(log_func, (void *)log_file);
 	if (log_file)
 		Log("Started logging to \"%s\"", filename);
 
@@ -79,9 +941,156 @@ int Logging_Init(const char *filename, SDL_bool append)
 
 void Logging_Quit(void)
 {
+	/* stop drain thread, it writes out everything still queued */
+	if (log_thread)
+	{
+		SDL_AtomicSet(&log_thread_running, 0);
+		SDL_WaitThread(log_thread, NULL);
+		log_thread = NULL;
+	}
+	else
+	{
+		summarize_ratelimits(SDL_TRUE);
+	}
+
+#ifdef NEUROTTIC_BINARY_LOG
+	binlog_close();
+#endif
+
 	SDL_SetLogOutputFunction(NULL, NULL);
 	if (log_file) SDL_CloseIO(log_file);
 	log_file = NULL;
+
+	SDL_DestroyMutex(log_file_mutex);
+	log_file_mutex = NULL;
+}
+
+void Logging_Flush(void)
+{
+#ifdef NEUROTTIC_BINARY_LOG
+	if (SDL_AtomicGet(&binlog_active))
+	{
+		binlog_drain();
+
+		SDL_LockMutex(binlog_mutex);
+		binlog_flush();
+		SDL_UnlockMutex(binlog_mutex);
+	}
+#endif
+
+	if (!log_thread)
+		return;
+
+	while (SDL_AtomicGet(&dequeue_pos) != SDL_AtomicGet(&enqueue_pos))
+		SDL_Delay(1);
+}
+
+int Logging_SetPriority(int category, SDL_LogPriority priority)
+{
+	if (category < 0 || category >= LOG_NUM_CATEGORIES || !category_names[category])
+		return LogError("Logging_SetPriority(): Invalid category %d", category);
+
+	if (priority < SDL_LOG_PRIORITY_VERBOSE || priority > SDL_NUM_LOG_PRIORITIES)
+		return LogError("Logging_SetPriority(): Invalid priority %d", priority);
+
+	log_priorities[category] = priority;
+	SDL_SetLogPriority(category, priority);
+
+	return 0;
+}
+
+int Logging_FindCategory(const char *name)
+{
+	for (int i = 0; i < LOG_NUM_CATEGORIES; i++)
+	{
+		if (category_names[i] && SDL_strcasecmp(category_names[i], name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+const char *Logging_GetCategoryName(int category)
+{
+	if (category < 0 || category >= LOG_NUM_CATEGORIES)
+		return NULL;
+
+	return category_names[category];
+}
+
+SDL_LogPriority Logging_FindPriority(const char *name)
+{
+	for (int i = SDL_LOG_PRIORITY_VERBOSE; i <= SDL_NUM_LOG_PRIORITIES; i++)
+	{
+		if (SDL_strcasecmp(priority_names[i], name) == 0)
+			return i;
+	}
+
+	return 0;
+}
+
+const char *Logging_GetPriorityName(SDL_LogPriority priority)
+{
+	if (priority < SDL_LOG_PRIORITY_VERBOSE || priority > SDL_NUM_LOG_PRIORITIES)
+		return NULL;
+
+	return priority_names[priority];
+}
+
+SDL_bool Logging_RateLimit(log_ratelimit_t *ratelimit, int category, SDL_LogPriority priority, const char *file, int line)
+{
+	Uint32 now;
+	int start;
+
+	if (ratelimit_max <= 0)
+		return SDL_TRUE;
+
+	/* start a new interval, summarizing the last one unless the drain thread
+	 * already did. only the thread that moves start resets the count */
+	now = (Uint32)SDL_GetTicks();
+	start = SDL_AtomicGet(&ratelimit->start);
+	if (now - (Uint32)start >= LOG_RATELIMIT_INTERVAL && SDL_AtomicCompareAndSwap(&ratelimit->start, start, (int)now))
+	{
+		SDL_AtomicSet(&ratelimit->count, 0);
+
+		if (SDL_AtomicGet(&ratelimit->registered) == LOG_RATELIMIT_REGISTERED)
+			summarize_ratelimit(ratelimit);
+	}
+
+	if (SDL_AtomicAdd(&ratelimit->count, 1) < ratelimit_max)
+		return SDL_TRUE;
+
+	/* hand the call site to the drain thread the first time it suppresses
+	 * anything, once the fields it reads are filled in */
+	if (SDL_AtomicCompareAndSwap(&ratelimit->registered, LOG_RATELIMIT_UNREGISTERED, LOG_RATELIMIT_REGISTERING))
+	{
+		int site;
+
+		ratelimit->category = category;
+		ratelimit->priority = priority;
+		ratelimit->file = file;
+		ratelimit->line = line;
+
+		SDL_AtomicSet(&ratelimit->registered, LOG_RATELIMIT_REGISTERED);
+
+		site = SDL_AtomicAdd(&num_ratelimit_sites, 1);
+		if (site < LOG_RATELIMIT_MAX_SITES)
+			SDL_AtomicSetPtr((void **)&ratelimit_sites[site], ratelimit);
+	}
+
+	SDL_AtomicAdd(&ratelimit->suppressed, 1);
+
+	return SDL_FALSE;
+}
+
+void Logging_SetRateLimit(int max_per_interval)
+{
+	ratelimit_max = max_per_interval;
+}
+
+int Logging_GetRateLimit(void)
+{
+	return ratelimit_max;
 }
 
 const char *SDL_IOStream_StatusString(SDL_IOStatus status)
@@ -32,26 +32,183 @@ extern "C" {
 /* start logging to specified filename, or NULL */
 int Logging_Init(const char *filename, SDL_bool append);
 
-/* shutdown logging */
+/* shutdown logging, writes out any queued messages */
 void Logging_Quit(void);
 
+/* block until all queued messages have been written out */
+void Logging_Flush(void);
+
 /* get an iostream status code as a string */
 const char *SDL_IOStream_StatusString(SDL_IOStatus status);
 
+/*
+ *
+ * binary log
+ *
+ * when built with NEUROTTIC_BINARY_LOG, the log macros write compact binary
+ * records to "<logfile>.bin" instead of formatting text. only warnings and
+ * above still go to the text outputs. the file is a stream of records, each
+ * starting with a one byte type, in host byte order:
+ *
+ * LOG_BINARY_HEADER: char magic[4], Uint32 version, Uint64 timer frequency
+ * LOG_BINARY_FORMAT: Uint16 id, Uint16 length, char format[length]
+ * LOG_BINARY_EVENT: Uint16 format id, Uint8 category, Uint8 priority,
+ *                   Uint32 thread id, Uint64 timestamp, Uint16 size,
+ *                   Uint8 args[size]
+ *
+ * integer arguments are stored as 4 bytes, or 8 bytes if they have a length
+ * modifier wider than int. floating point and pointer arguments are stored
+ * as 8 bytes. strings are stored as Uint16 length followed by the bytes.
+ * format id 0 is always "%s", used for messages that couldn't be encoded.
+ *
+ * events are encoded on the calling thread and pushed into a lock-free
+ * queue, the drain thread writes them out. each call site with a literal
+ * format string remembers its format id, so only its first message in a
+ * session takes a lock.
+ *
+ * use neurottic_logdecode to turn it back into text.
+ *
+ */
+
+#define LOG_BINARY_MAGIC "NLOG"
+#define LOG_BINARY_VERSION (1)
+#define LOG_BINARY_HEADER (0)
+#define LOG_BINARY_FORMAT (1)
+#define LOG_BINARY_EVENT (2)
+#define LOG_BINARY_MAX_ARGS (16)
+
+#ifdef NEUROTTIC_BINARY_LOG
+
+typedef struct log_binary_site {
+	SDL_AtomicInt format; /* session and format id, set by Logging_Binary() */
+} log_binary_site_t;
+
+/* write binary log record, site may be NULL if fmt isn't a literal */
+void Logging_Binary(log_binary_site_t *site, int category, SDL_LogPriority priority, SDL_PRINTF_FORMAT_STRING const char *fmt, ...) SDL_PRINTF_VARARG_FUNC(4);
+
+#define LOG_FORMAT(fmt, ...) (fmt)
+
+#define LOG_OUTPUT(category, priority, ...) ({ \
+	static log_binary_site_t _log_binary_site; \
+	Logging_Binary(__builtin_constant_p(LOG_FORMAT(__VA_ARGS__, 0)) ? &_log_binary_site : NULL, \
+		(category), (priority), __VA_ARGS__); \
+})
+
+#else
+
+#define LOG_OUTPUT SDL_LogMessage
+
+#endif /* NEUROTTIC_BINARY_LOG */
+
+/*
+ *
+ * categories
+ *
+ * define LOG_CATEGORY before including neurottic.h to set the category used
+ * by the log macros in that file.
+ *
+ */
+
+enum {
+	LOG_CATEGORY_LM = SDL_LOG_CATEGORY_CUSTOM,
+	LOG_CATEGORY_MS,
+	LOG_CATEGORY_R,
+	LOG_CATEGORY_AU,
+	LOG_CATEGORY_CON,
+	LOG_NUM_CATEGORIES
+};
+
+#ifndef LOG_CATEGORY
+#define LOG_CATEGORY SDL_LOG_CATEGORY_APPLICATION
+#endif
+
+/* lowest priority let through for each category */
+extern SDL_LogPriority log_priorities[LOG_NUM_CATEGORIES];
+
+/* set lowest priority let through for category, SDL_NUM_LOG_PRIORITIES disables it */
+int Logging_SetPriority(int category, SDL_LogPriority priority);
+
+/* get category by name, or -1 */
+int Logging_FindCategory(const char *name);
+
+/* get name of category, or NULL */
+const char *Logging_GetCategoryName(int category);
+
+/* get priority by name, or 0 */
+SDL_LogPriority Logging_FindPriority(const char *name);
+
+/* get name of priority */
+const char *Logging_GetPriorityName(SDL_LogPriority priority);
+
+/*
+ *
+ * rate limiting
+ *
+ * each call site of the log macros may emit a limited number of warnings and
+ * lower per second. anything over that is counted, and the logging thread
+ * summarizes the counts every second and at shutdown. the counts are
+ * approximate if a call site is hit from many threads. errors and critical
+ * messages are never limited.
+ *
+ */
+
+#define LOG_RATELIMIT_DEFAULT (32)
+#define LOG_RATELIMIT_INTERVAL (1000)
+#define LOG_RATELIMIT_MAX_SITES (256)
+
+/* states of log_ratelimit_t.registered */
+#define LOG_RATELIMIT_UNREGISTERED (0)
+#define LOG_RATELIMIT_REGISTERING (1)
+#define LOG_RATELIMIT_REGISTERED (2)
+
+typedef struct log_ratelimit {
+	SDL_AtomicInt start; /* low 32 bits of SDL_GetTicks() */
+	SDL_AtomicInt count;
+	SDL_AtomicInt suppressed;
+	SDL_AtomicInt registered;
+	int category; /* the rest is only valid once registered */
+	SDL_LogPriority priority;
+	const char *file;
+	int line;
+} log_ratelimit_t;
+
+/* returns SDL_TRUE if call site may log another message */
+SDL_bool Logging_RateLimit(log_ratelimit_t *ratelimit, int category, SDL_LogPriority priority, const char *file, int line);
+
+/* set number of messages per second allowed from each call site, 0 disables limiting */
+void Logging_SetRateLimit(int max_per_interval);
+
+/* get number of messages per second allowed from each call site */
+int Logging_GetRateLimit(void);
+
+/*
+ *
+ * macros
+ *
+ */
+
+/* a filtered message costs one comparison, the arguments aren't evaluated */
+#define LOG_MESSAGE(priority, ...) ({ \
+	static log_ratelimit_t _log_ratelimit; \
+	if ((priority) >= log_priorities[LOG_CATEGORY] && ((priority) >= SDL_LOG_PRIORITY_ERROR || \
+		Logging_RateLimit(&_log_ratelimit, LOG_CATEGORY, (priority), __FILE__, __LINE__))) \
+		LOG_OUTPUT(LOG_CATEGORY, (priority), __VA_ARGS__); \
+})
+
 /* log standard message */
-#define Log(...) ({SDL_Log(__VA_ARGS__); 0;})
+#define Log(...) ({LOG_MESSAGE(SDL_LOG_PRIORITY_INFO, __VA_ARGS__); 0;})
 
 /* log verbose message */
-#define LogVerbose(...) (SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, __VA_ARGS__), 0)
+#define LogVerbose(...) ({LOG_MESSAGE(SDL_LOG_PRIORITY_VERBOSE, __VA_ARGS__); 0;})
 
 /* log warning message */
-#define LogWarning(...) (SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, __VA_ARGS__), 0)
+#define LogWarning(...) ({LOG_MESSAGE(SDL_LOG_PRIORITY_WARN, __VA_ARGS__); 0;})
 
 /* log critical message */
-#define LogCritical(...) (SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, __VA_ARGS__), 0)
+#define LogCritical(...) ({LOG_MESSAGE(SDL_LOG_PRIORITY_CRITICAL, __VA_ARGS__); 0;})
 
-/* log error message */
-#define LogError(...) (SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, __VA_ARGS__), SDL_SetError(__VA_ARGS__))
+/* log error message, the error is set even if the message is filtered */
+#define LogError(...) ({LOG_MESSAGE(SDL_LOG_PRIORITY_ERROR, __VA_ARGS__); SDL_SetError(__VA_ARGS__);})
 
 #ifdef __cplusplus
 }
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_LM
 #include "neurottic.h"
 
 /*
@@ -72,6 +73,9 @@ static char **paths = NULL;
 static int num_cached_pics = 0;
 static cached_pic_t *cached_pics = NULL;
 
+/* statistics */
+static lm_stats_t stats = {};
+
 /*
  *
  * public functions
@@ -81,6 +85,8 @@ static cached_pic_t *cached_pics = NULL;
 /* startup lump manager */
 int LM_Init(void)
 {
+	PROFILE_FUNCTION();
+
 	if (started)
 		return LogError("LM_Init(): Lump manager already started");
 
@@ -92,6 +98,8 @@ int LM_Init(void)
 /* shutdown lump manager */
 void LM_Quit(void)
 {
+	PROFILE_FUNCTION();
+
 	if (wads)
 	{
 		for (int i = 0; i < num_wads; i++)
@@ -144,12 +152,16 @@ void LM_Quit(void)
 	num_cached_pics = 0;
 	cached_pics = NULL;
 
+	SDL_memset(&stats, 0, sizeof(stats));
+
 	started = SDL_FALSE;
 }
 
 /* add wad to lump manager */
 int LM_AddWAD(const char *filename)
 {
+	PROFILE_FUNCTION();
+
 	SDL_IOStream *io = NULL;
 	wad_t *wad = NULL;
 	void *data = NULL;
@@ -236,6 +248,8 @@ done:
 /* add filesystem path to lump manager */
 int LM_AddPath(const char *path)
 {
+	PROFILE_FUNCTION();
+
 	SDL_PathInfo info;
 
 	/* stoopid */
@@ -261,8 +275,12 @@ int LM_AddPath(const char *path)
 /* load entire lump into buffer. this data should be freed with SDL_free */
 void *LM_LoadLump(const char *name, size_t *sz)
 {
+	PROFILE_FUNCTION();
+
 	int i, x;
 
+	stats.lump_lookups++;
+
 	/* search paths */
 	i = num_paths;
 	while (--i >= 0)
@@ -295,6 +313,7 @@ void *LM_LoadLump(const char *name, size_t *sz)
 		}
 	}
 
+	stats.lump_misses++;
 	LogError("LM_LoadLump(): Lump \"%s\" was not found", name);
 	return NULL;
 }
@@ -302,8 +321,12 @@ void *LM_LoadLump(const char *name, size_t *sz)
 /* open lump for reading with SDL_IOStream */
 SDL_IOStream *LM_OpenLumpIO(const char *name)
 {
+	PROFILE_FUNCTION();
+
 	int i, x;
 
+	stats.lump_lookups++;
+
 	/* search paths */
 	i = num_paths;
 	while (--i >= 0)
@@ -335,6 +358,7 @@ SDL_IOStream *LM_OpenLumpIO(const char *name)
 		}
 	}
 
+	stats.lump_misses++;
 	LogError("LM_OpenLumpIO(): Lump \"%s\" was not found", name);
 	return NULL;
 }
@@ -342,6 +366,8 @@ SDL_IOStream *LM_OpenLumpIO(const char *name)
 /* get lump index by name */
 Sint32 LM_GetLumpIndex(const char *name)
 {
+	PROFILE_FUNCTION();
+
 	int i, x;
 
 	/* search wads */
@@ -377,15 +403,20 @@ Sint32 LM_GetLumpIndex(const char *name)
 
 SDL_Surface *LM_CachePic(const char *name)
 {
+	PROFILE_FUNCTION();
+
 	/* check if cached */
 	for (int i = 0; i < num_cached_pics; i++)
 	{
 		if (SDL_strncasecmp(name, cached_pics[i].name, 8) == 0)
 		{
+			stats.pic_hits++;
 			return cached_pics[i].surface;
 		}
 	}
 
+	stats.pic_misses++;
+
 	/* load lump */
 	SDL_IOStream *io = LM_OpenLumpIO(name);
 	if (!io)
@@ -409,3 +440,13 @@ SDL_Surface *LM_CachePic(const char *name)
 
 	return surface;
 }
+
+/* get lump lookup and pic cache statistics */
+void LM_GetStats(lm_stats_t *out)
+{
+	if (!out)
+		return;
+
+	*out = stats;
+	out->num_cached_pics = num_cached_pics;
+}
@@ -90,6 +90,17 @@ SDL_IOStream *LM_OpenLumpIO(const char *name);
  */
 Sint32 LM_GetLumpIndex(const char *name);
 
+typedef struct lm_stats {
+	Uint32 lump_lookups;
+	Uint32 lump_misses;
+	Uint32 pic_hits;
+	Uint32 pic_misses;
+	int num_cached_pics;
+} lm_stats_t;
+
+/* get lump lookup and pic cache statistics */
+void LM_GetStats(lm_stats_t *stats);
+
 /* cache lump pic
  *
  * returns NULL if some error occured, otherwise a pointer to an SDL_Surface
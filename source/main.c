@@ -24,20 +24,31 @@ SOFTWARE.
 
 #include "neurottic.h"
 
+/* the benchmark harness provides its own main() */
+#ifndef NEUROTTIC_BENCHMARK
 #define SDL_MAIN_USE_CALLBACKS
+#define SDL_MAIN_NOIMPL
 #include <SDL3/SDL_main.h>
+#endif
 
 #include "grayscale_palette.h"
 
-/* current game state enum */
-enum {
-	GAMESTATE_CONSOLE,
-	GAMESTATE_MENU,
-	GAMESTATE_LOADING,
-	GAMESTATE_INGAME,
-};
+/* quit once all queued console commands have run */
+static SDL_bool quit_when_idle = SDL_FALSE;
 
-static int gamestate = GAMESTATE_CONSOLE;
+/* command line flags, anything else after a +command is one of its arguments */
+static const char *flags[] = {"-quit", "-headless"};
+
+static SDL_bool IsFlag(const char *arg)
+{
+	for (int i = 0; i < SDL_arraysize(flags); i++)
+	{
+		if (SDL_strcmp(arg, flags[i]) == 0)
+			return SDL_TRUE;
+	}
+
+	return SDL_FALSE;
+}
 
 /*
  * load assets
@@ -98,23 +109,38 @@ static void UpdateTime(void)
 void Quit(void)
 {
 	Log("Shutting down");
+	Demo_Quit();
+	G_Quit();
 	R_Quit();
 	MS_UnloadMapSet();
 	AU_Quit();
 	LM_Quit();
 	FS_Quit();
 	Logging_Quit();
+	/* after everything that holds cvars */
 	Console_Quit();
+	Profiler_Quit();
 	SDLNet_Quit();
 	SDL_Quit();
 }
 
 int Start(void)
 {
+	/* start logging, the log file is opened once the console is up */
+	if (Logging_Init(NULL, SDL_FALSE) != 0)
+		return -1;
+
 	/* sdl */
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0)
 		return -1;
 
+	/* profiler */
+	if (Profiler_Init() != 0)
+		return -1;
+
+	/* trig tables, before anything is drawn */
+	Trig_Init();
+
 	/* sdl_net */
 	if (SDLNet_Init() != 0)
 		return -1;
@@ -134,7 +160,7 @@ int Start(void)
 	/* set grayscale palette before game data is loaded */
 	R_SetPalette(grayscale_palette);
 
-	/* start logging */
+	/* open log file */
 	if (Logging_Init("neurottic.log", SDL_FALSE) != 0)
 		return -1;
 
@@ -146,6 +172,14 @@ int Start(void)
 	if (AU_Init() != 0)
 		return -1;
 
+	/* game */
+	if (G_Init() != 0)
+		return -1;
+
+	/* demos */
+	if (Demo_Init() != 0)
+		return -1;
+
 	/* start counting time */
 	StartTime();
 
@@ -162,6 +196,7 @@ void Die(const char *fmt, ...)
 	va_end(ap);
 
 	LogCritical(error);
+	Logging_Flush();
 	SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Critical Error", error, NULL);
 
 	Quit();
@@ -169,12 +204,32 @@ void Die(const char *fmt, ...)
 	exit(1);
 }
 
+#ifndef NEUROTTIC_BENCHMARK
+
 /*
  * sdl_main callbacks
  */
 
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv)
 {
+	static char cmd[1024];
+
+	/* command line flags */
+	for (int i = 1; i < argc; i++)
+	{
+		if (SDL_strcmp(argv[i], "-quit") == 0)
+		{
+			quit_when_idle = SDL_TRUE;
+		}
+		else if (SDL_strcmp(argv[i], "-headless") == 0)
+		{
+			/* no window or audio device, for unattended runs */
+			SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+			SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+			SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		}
+	}
+
 	/* startup systems */
 	if (Start() != 0)
 		Die(SDL_GetError());
@@ -185,6 +240,30 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv)
 
 	R_SurfaceFromFontIO(LM_OpenLumpIO("NEWFNT1"), SDL_TRUE);
 
+	/* queue +command arguments, each one runs up to the next +command or flag,
+	 * so negative numbers like "+r_light -1" stay arguments */
+	for (int i = 1; i < argc; i++)
+	{
+		if (argv[i][0] != '+')
+			continue;
+
+		size_t len = SDL_strlcpy(cmd, argv[i] + 1, sizeof(cmd));
+
+		while (i + 1 < argc && argv[i + 1][0] != '+' && !IsFlag(argv[i + 1]))
+		{
+			SDL_strlcat(cmd, " ", sizeof(cmd));
+			len = SDL_strlcat(cmd, argv[++i], sizeof(cmd));
+		}
+
+		if (len >= sizeof(cmd))
+		{
+			LogWarning("Skipping command line command longer than %d characters: \"%.32s...\"", (int)sizeof(cmd) - 1, cmd);
+			continue;
+		}
+
+		Console_AddText(cmd);
+	}
+
 	return 0;
 }
 
@@ -195,21 +274,50 @@ void SDL_AppQuit(void *appstate)
 
 SDL_AppResult SDL_AppIterate(void *appstate)
 {
+	Perf_BeginFrame();
+
+	/* run queued console commands */
+	Console_Execute();
+
+	if (quit_when_idle && Console_IsIdle() && !Demo_IsPlaying())
+		return 1;
+
+	/* run game tick */
+	G_Tick();
+	Perf_Mark(PERF_SIMULATION);
+
 	R_Clear(0x00);
 
-	switch (gamestate)
+	if (G_GetGameState() == GAMESTATE_INGAME)
+		R_Draw();
+
+	Perf_Mark(PERF_RAYCAST);
+
+	switch (G_GetGameState())
 	{
 		case GAMESTATE_CONSOLE:
 			R_DrawConsole();
 			break;
 
+		case GAMESTATE_INGAME:
+			break;
+
 		default:
 			return -1;
 	}
 
+	R_DrawOverlay();
+	Perf_Mark(PERF_2D);
+
 	R_Flip();
 
-	UpdateTime();
+	Perf_EndFrame();
+
+	/* timedemos run as fast as possible */
+	if (Demo_IsTiming())
+		StartTime();
+	else
+		UpdateTime();
 
 	return 0;
 }
@@ -220,17 +328,52 @@ SDL_AppResult SDL_AppEvent(void *appstate, const SDL_Event *event)
 	if (event->type == SDL_EVENT_QUIT)
 		return 1;
 
+	/* toggle console */
+	if (event->type == SDL_EVENT_KEY_DOWN && event->key.key == SDLK_GRAVE)
+	{
+		if (G_GetGameState() == GAMESTATE_CONSOLE && MS_GetCurrentMap() >= 0)
+			G_SetGameState(GAMESTATE_INGAME);
+		else if (G_GetGameState() == GAMESTATE_INGAME)
+			G_SetGameState(GAMESTATE_CONSOLE);
+
+		return 0;
+	}
+
 	/* handle gamestate-specific events */
-	switch (gamestate)
+	switch (G_GetGameState())
 	{
 		case GAMESTATE_CONSOLE:
 			if (event->type == SDL_EVENT_KEY_DOWN)
 				Console_HandleInput(event->key.key);
 			break;
 
+		case GAMESTATE_INGAME:
+			G_Responder(event);
+			break;
+
 		default:
 			break;
 	}
 
 	return 0;
 }
+
+/*
+ * entry point
+ */
+
+static int SDLCALL AppMain(int argc, char **argv)
+{
+	return SDL_EnterAppMainCallbacks(argc, argv, SDL_AppInit, SDL_AppIterate, SDL_AppEvent, SDL_AppQuit);
+}
+
+/* SDL_RunApp() already allocates (the Windows argv, for one), so the heap
+ * is counted from here instead of SDL_AppInit() */
+int main(int argc, char **argv)
+{
+	Perf_TrackHeap();
+
+	return SDL_RunApp(argc, argv, AppMain, NULL);
+}
+
+#endif /* NEUROTTIC_BENCHMARK */
@@ -30,6 +30,7 @@ extern "C" {
 #endif
 
 int Start(void);
+int LoadAssets(void);
 void Quit(void);
 void Die(const char *fmt, ...);
 
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_MS
 #include "neurottic.h"
 
 /*
@@ -45,6 +46,14 @@ enum {
 	MAP_OPEN_PUSHWALLS = 1 << 0
 };
 
+/* player start objects in plane 1 */
+enum {
+	OBJ_PLAYERSTART_NORTH = 19,
+	OBJ_PLAYERSTART_EAST = 20,
+	OBJ_PLAYERSTART_SOUTH = 21,
+	OBJ_PLAYERSTART_WEST = 22
+};
+
 /* map structure */
 typedef struct map {
 	Uint32 used;
@@ -81,6 +90,7 @@ static Uint32 mapset_version = 0;
 
 /* current map */
 static map_t maps[100] = {};
+static char map_names[100][25] = {};
 static int map_index = -1;
 static Uint16 *map_planes[3] = {};
 
@@ -165,6 +175,10 @@ int MS_LoadMapSet(const char *filename)
 		SDL_ReadU32LE(io, &maps[i].plane_sizes[2]);
 		SDL_ReadIO(io, maps[i].name, 24);
 
+		/* names aren't guaranteed to be terminated on disk */
+		SDL_memcpy(map_names[i], maps[i].name, 24);
+		map_names[i][24] = '\0';
+
 		if (maps[i].tag == rle_tag_registered)
 			flags |= MAPSET_REGISTERED;
 		else if (maps[i].tag == rle_tag_shareware)
@@ -191,6 +205,7 @@ void MS_UnloadMapSet(void)
 		SDL_CloseIO(mapset_io);
 
 	SDL_memset(maps, 0, sizeof(maps));
+	SDL_memset(map_names, 0, sizeof(map_names));
 
 	mapset_io = NULL;
 	mapset_filename = NULL;
@@ -198,6 +213,8 @@ void MS_UnloadMapSet(void)
 
 int MS_LoadMap(int map)
 {
+	PROFILE_FUNCTION();
+
 	/* out of range */
 	if (map < 0 || map >= 100)
 		return LogError("MS_LoadMap(): Map %d is out of range", map);
@@ -251,3 +268,56 @@ Uint16 *MS_GetCurrentMapPlane(int plane)
 
 	return map_planes[plane];
 }
+
+/* get index of the currently loaded map, or -1 if none is loaded */
+int MS_GetCurrentMap(void)
+{
+	return map_index;
+}
+
+/* returns SDL_TRUE if the map slot is used in the current mapset */
+SDL_bool MS_MapIsUsed(int map)
+{
+	if (map < 0 || map >= 100)
+		return SDL_FALSE;
+
+	return maps[map].used ? SDL_TRUE : SDL_FALSE;
+}
+
+/* get name of map from current mapset, or NULL if out of range */
+const char *MS_GetMapName(int map)
+{
+	if (map < 0 || map >= 100)
+		return NULL;
+
+	return map_names[map];
+}
+
+/* find player start in current map */
+int MS_FindPlayerStart(int *x, int *y, int *angle)
+{
+	static const int angles[] = {
+		[OBJ_PLAYERSTART_NORTH - OBJ_PLAYERSTART_NORTH] = 90,
+		[OBJ_PLAYERSTART_EAST - OBJ_PLAYERSTART_NORTH] = 0,
+		[OBJ_PLAYERSTART_SOUTH - OBJ_PLAYERSTART_NORTH] = 270,
+		[OBJ_PLAYERSTART_WEST - OBJ_PLAYERSTART_NORTH] = 180
+	};
+
+	if (!map_planes[1])
+		return LogError("MS_FindPlayerStart(): No map loaded");
+
+	for (int i = 0; i < 128 * 128; i++)
+	{
+		Uint16 obj = map_planes[1][i];
+
+		if (obj >= OBJ_PLAYERSTART_NORTH && obj <= OBJ_PLAYERSTART_WEST)
+		{
+			if (x) *x = i % 128;
+			if (y) *y = i / 128;
+			if (angle) *angle = angles[obj - OBJ_PLAYERSTART_NORTH];
+			return 0;
+		}
+	}
+
+	return LogError("MS_FindPlayerStart(): Map %d has no player start", map_index);
+}
@@ -44,6 +44,22 @@ void MS_UnloadMap(void);
 /* get pointer to decompressed plane from current map (valid range is 0-2) */
 Uint16 *MS_GetCurrentMapPlane(int plane);
 
+/* get index of the currently loaded map, or -1 if none is loaded */
+int MS_GetCurrentMap(void);
+
+/* returns SDL_TRUE if the map slot is used in the current mapset */
+SDL_bool MS_MapIsUsed(int map);
+
+/* get name of map from current mapset, or NULL if out of range */
+const char *MS_GetMapName(int map);
+
+/* find player start in current map
+ *
+ * angle is returned in degrees, 0 facing east and 90 facing north. returns
+ * -1 if the map has no player start.
+ */
+int MS_FindPlayerStart(int *x, int *y, int *angle);
+
 #ifdef __cplusplus
 }
 #endif
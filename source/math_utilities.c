@@ -122,20 +122,11 @@ int towards(int value, int change, int to)
 
 void Vec3f_anglevectors(Vec3f angles, Vec3f *forward, Vec3f *right, Vec3f *up)
 {
-	float angle;
 	float sr, sp, sy, cr, cp, cy;
 
-	angle = deg2radf(angles.y);
-	sy = SDL_sinf(angle);
-	cy = SDL_cosf(angle);
-
-	angle = deg2radf(angles.x);
-	sp = SDL_sinf(angle);
-	cp = SDL_cosf(angle);
-
-	angle = deg2radf(angles.z);
-	sr = SDL_sinf(angle);
-	cr = SDL_cosf(angle);
+	Trig_SinCos(deg2radf(angles.y), &sy, &cy);
+	Trig_SinCos(deg2radf(angles.x), &sp, &cp);
+	Trig_SinCos(deg2radf(angles.z), &sr, &cr);
 
 	if (forward)
 	{
@@ -185,3 +176,394 @@ float Vec3f_normalize(Vec3f *v)
 	v->z /= w;
 	return w;
 }
+
+/*
+ *
+ * batch routines
+ *
+ */
+
+typedef struct batch_funcs {
+	void (*transform)(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n);
+	void (*project)(const Projection *p, const float *x, const float *y, float *column, float *depth, int n);
+	void (*normalize)(float *x, float *y, float *z, float *lengths, int n);
+	void (*distance)(Vec3f point, const float *x, const float *y, const float *z, float *out, int n);
+} batch_funcs_t;
+
+/*
+ * scalar, also used for the leftovers of the simd paths. the simd paths do
+ * the same operations in the same order so the results match exactly.
+ */
+
+static void transform_scalar(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float px = x[i], py = y[i], pz = z[i];
+		ox[i] = m->m[0][0] * px + m->m[1][0] * py + m->m[2][0] * pz + m->m[3][0];
+		oy[i] = m->m[0][1] * px + m->m[1][1] * py + m->m[2][1] * pz + m->m[3][1];
+		oz[i] = m->m[0][2] * px + m->m[1][2] * py + m->m[2][2] * pz + m->m[3][2];
+	}
+}
+
+static void project_scalar(const Projection *p, const float *x, const float *y, float *column, float *depth, int n)
+{
+	float rx = -p->forward.y, ry = p->forward.x;
+
+	for (int i = 0; i < n; i++)
+	{
+		float dx = x[i] - p->origin.x;
+		float dy = y[i] - p->origin.y;
+		float d = dx * p->forward.x + dy * p->forward.y;
+		float side = dx * rx + dy * ry;
+
+		if (d >= p->min_depth)
+		{
+			column[i] = p->center + side * p->focal / d;
+			depth[i] = d;
+		}
+		else
+		{
+			column[i] = 0;
+			depth[i] = 0;
+		}
+	}
+}
+
+static void normalize_scalar(float *x, float *y, float *z, float *lengths, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float w = SDL_sqrtf(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+		if (w > 0)
+		{
+			x[i] /= w;
+			y[i] /= w;
+			z[i] /= w;
+		}
+
+		if (lengths)
+			lengths[i] = w;
+	}
+}
+
+static void distance_scalar(Vec3f point, const float *x, const float *y, const float *z, float *out, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float dx = x[i] - point.x;
+		float dy = y[i] - point.y;
+		float dz = z[i] - point.z;
+		out[i] = SDL_sqrtf(dx * dx + dy * dy + dz * dz);
+	}
+}
+
+static const batch_funcs_t batch_scalar = {
+	transform_scalar, project_scalar, normalize_scalar, distance_scalar
+};
+
+/*
+ * sse2, 4 at a time
+ */
+
+#ifdef SDL_SSE2_INTRINSICS
+
+static void SDL_TARGETING("sse2") transform_sse2(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n)
+{
+	__m128 c[4][3];
+	int i;
+
+	for (int col = 0; col < 4; col++)
+	{
+		for (int row = 0; row < 3; row++)
+			c[col][row] = _mm_set1_ps(m->m[col][row]);
+	}
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(x + i);
+		__m128 py = _mm_loadu_ps(y + i);
+		__m128 pz = _mm_loadu_ps(z + i);
+		__m128 r[3];
+
+		for (int row = 0; row < 3; row++)
+		{
+			r[row] = _mm_add_ps(_mm_mul_ps(c[0][row], px), _mm_mul_ps(c[1][row], py));
+			r[row] = _mm_add_ps(r[row], _mm_mul_ps(c[2][row], pz));
+			r[row] = _mm_add_ps(r[row], c[3][row]);
+		}
+
+		_mm_storeu_ps(ox + i, r[0]);
+		_mm_storeu_ps(oy + i, r[1]);
+		_mm_storeu_ps(oz + i, r[2]);
+	}
+
+	transform_scalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i);
+}
+
+static void SDL_TARGETING("sse2") project_sse2(const Projection *p, const float *x, const float *y, float *column, float *depth, int n)
+{
+	__m128 ox = _mm_set1_ps(p->origin.x), oy = _mm_set1_ps(p->origin.y);
+	__m128 fx = _mm_set1_ps(p->forward.x), fy = _mm_set1_ps(p->forward.y);
+	__m128 rx = _mm_set1_ps(-p->forward.y), ry = _mm_set1_ps(p->forward.x);
+	__m128 focal = _mm_set1_ps(p->focal), center = _mm_set1_ps(p->center);
+	__m128 min_depth = _mm_set1_ps(p->min_depth);
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), ox);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), oy);
+		__m128 d = _mm_add_ps(_mm_mul_ps(dx, fx), _mm_mul_ps(dy, fy));
+		__m128 side = _mm_add_ps(_mm_mul_ps(dx, rx), _mm_mul_ps(dy, ry));
+		__m128 col = _mm_add_ps(center, _mm_div_ps(_mm_mul_ps(side, focal), d));
+		__m128 visible = _mm_cmpge_ps(d, min_depth);
+
+		_mm_storeu_ps(column + i, _mm_and_ps(visible, col));
+		_mm_storeu_ps(depth + i, _mm_and_ps(visible, d));
+	}
+
+	project_scalar(p, x + i, y + i, column + i, depth + i, n - i);
+}
+
+static void SDL_TARGETING("sse2") normalize_sse2(float *x, float *y, float *z, float *lengths, int n)
+{
+	__m128 zero = _mm_setzero_ps();
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 vx = _mm_loadu_ps(x + i);
+		__m128 vy = _mm_loadu_ps(y + i);
+		__m128 vz = _mm_loadu_ps(z + i);
+		__m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+		__m128 nonzero;
+
+		w = _mm_sqrt_ps(w);
+		nonzero = _mm_cmpgt_ps(w, zero);
+
+		/* keep the original value where the length is zero */
+		_mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(vx, w)), _mm_andnot_ps(nonzero, vx)));
+		_mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(vy, w)), _mm_andnot_ps(nonzero, vy)));
+		_mm_storeu_ps(z + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(vz, w)), _mm_andnot_ps(nonzero, vz)));
+
+		if (lengths)
+			_mm_storeu_ps(lengths + i, w);
+	}
+
+	normalize_scalar(x + i, y + i, z + i, lengths ? lengths + i : NULL, n - i);
+}
+
+static void SDL_TARGETING("sse2") distance_sse2(Vec3f point, const float *x, const float *y, const float *z, float *out, int n)
+{
+	__m128 px = _mm_set1_ps(point.x), py = _mm_set1_ps(point.y), pz = _mm_set1_ps(point.z);
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), pz);
+		__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		_mm_storeu_ps(out + i, _mm_sqrt_ps(d));
+	}
+
+	distance_scalar(point, x + i, y + i, z + i, out + i, n - i);
+}
+
+static const batch_funcs_t batch_sse2 = {
+	transform_sse2, project_sse2, normalize_sse2, distance_sse2
+};
+
+#endif /* SDL_SSE2_INTRINSICS */
+
+/*
+ * avx2, 8 at a time
+ */
+
+#ifdef SDL_AVX2_INTRINSICS
+
+static void SDL_TARGETING("avx2") transform_avx2(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n)
+{
+	__m256 c[4][3];
+	int i;
+
+	for (int col = 0; col < 4; col++)
+	{
+		for (int row = 0; row < 3; row++)
+			c[col][row] = _mm256_set1_ps(m->m[col][row]);
+	}
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 px = _mm256_loadu_ps(x + i);
+		__m256 py = _mm256_loadu_ps(y + i);
+		__m256 pz = _mm256_loadu_ps(z + i);
+		__m256 r[3];
+
+		for (int row = 0; row < 3; row++)
+		{
+			r[row] = _mm256_add_ps(_mm256_mul_ps(c[0][row], px), _mm256_mul_ps(c[1][row], py));
+			r[row] = _mm256_add_ps(r[row], _mm256_mul_ps(c[2][row], pz));
+			r[row] = _mm256_add_ps(r[row], c[3][row]);
+		}
+
+		_mm256_storeu_ps(ox + i, r[0]);
+		_mm256_storeu_ps(oy + i, r[1]);
+		_mm256_storeu_ps(oz + i, r[2]);
+	}
+
+	transform_scalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i);
+}
+
+static void SDL_TARGETING("avx2") project_avx2(const Projection *p, const float *x, const float *y, float *column, float *depth, int n)
+{
+	__m256 ox = _mm256_set1_ps(p->origin.x), oy = _mm256_set1_ps(p->origin.y);
+	__m256 fx = _mm256_set1_ps(p->forward.x), fy = _mm256_set1_ps(p->forward.y);
+	__m256 rx = _mm256_set1_ps(-p->forward.y), ry = _mm256_set1_ps(p->forward.x);
+	__m256 focal = _mm256_set1_ps(p->focal), center = _mm256_set1_ps(p->center);
+	__m256 min_depth = _mm256_set1_ps(p->min_depth);
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), ox);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), oy);
+		__m256 d = _mm256_add_ps(_mm256_mul_ps(dx, fx), _mm256_mul_ps(dy, fy));
+		__m256 side = _mm256_add_ps(_mm256_mul_ps(dx, rx), _mm256_mul_ps(dy, ry));
+		__m256 col = _mm256_add_ps(center, _mm256_div_ps(_mm256_mul_ps(side, focal), d));
+		__m256 visible = _mm256_cmp_ps(d, min_depth, _CMP_GE_OQ);
+
+		_mm256_storeu_ps(column + i, _mm256_and_ps(visible, col));
+		_mm256_storeu_ps(depth + i, _mm256_and_ps(visible, d));
+	}
+
+	project_scalar(p, x + i, y + i, column + i, depth + i, n - i);
+}
+
+static void SDL_TARGETING("avx2") normalize_avx2(float *x, float *y, float *z, float *lengths, int n)
+{
+	__m256 zero = _mm256_setzero_ps();
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 vx = _mm256_loadu_ps(x + i);
+		__m256 vy = _mm256_loadu_ps(y + i);
+		__m256 vz = _mm256_loadu_ps(z + i);
+		__m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+		__m256 nonzero;
+
+		w = _mm256_sqrt_ps(w);
+		nonzero = _mm256_cmp_ps(w, zero, _CMP_GT_OQ);
+
+		/* keep the original value where the length is zero */
+		_mm256_storeu_ps(x + i, _mm256_blendv_ps(vx, _mm256_div_ps(vx, w), nonzero));
+		_mm256_storeu_ps(y + i, _mm256_blendv_ps(vy, _mm256_div_ps(vy, w), nonzero));
+		_mm256_storeu_ps(z + i, _mm256_blendv_ps(vz, _mm256_div_ps(vz, w), nonzero));
+
+		if (lengths)
+			_mm256_storeu_ps(lengths + i, w);
+	}
+
+	normalize_scalar(x + i, y + i, z + i, lengths ? lengths + i : NULL, n - i);
+}
+
+static void SDL_TARGETING("avx2") distance_avx2(Vec3f point, const float *x, const float *y, const float *z, float *out, int n)
+{
+	__m256 px = _mm256_set1_ps(point.x), py = _mm256_set1_ps(point.y), pz = _mm256_set1_ps(point.z);
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), px);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), py);
+		__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), pz);
+		__m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+		_mm256_storeu_ps(out + i, _mm256_sqrt_ps(d));
+	}
+
+	distance_scalar(point, x + i, y + i, z + i, out + i, n - i);
+}
+
+static const batch_funcs_t batch_avx2 = {
+	transform_avx2, project_avx2, normalize_avx2, distance_avx2
+};
+
+#endif /* SDL_AVX2_INTRINSICS */
+
+/*
+ * dispatch
+ */
+
+static const batch_funcs_t *batch = NULL;
+static int simd_level = MATH_SIMD_NONE;
+
+int Math_SetSIMD(int level)
+{
+	batch = &batch_scalar;
+	simd_level = MATH_SIMD_NONE;
+
+#ifdef SDL_AVX2_INTRINSICS
+	if (level >= MATH_SIMD_AVX2 && SDL_HasAVX2())
+	{
+		batch = &batch_avx2;
+		simd_level = MATH_SIMD_AVX2;
+		return simd_level;
+	}
+#endif
+
+#ifdef SDL_SSE2_INTRINSICS
+	if (level >= MATH_SIMD_SSE2 && SDL_HasSSE2())
+	{
+		batch = &batch_sse2;
+		simd_level = MATH_SIMD_SSE2;
+		return simd_level;
+	}
+#endif
+
+	return simd_level;
+}
+
+int Math_GetSIMD(void)
+{
+	if (!batch)
+		Math_SetSIMD(MATH_SIMD_BEST);
+
+	return simd_level;
+}
+
+void Vec3f_transform_n(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n)
+{
+	if (!batch)
+		Math_SetSIMD(MATH_SIMD_BEST);
+
+	batch->transform(m, x, y, z, ox, oy, oz, n);
+}
+
+void Vec2f_project_n(const Projection *p, const float *x, const float *y, float *column, float *depth, int n)
+{
+	if (!batch)
+		Math_SetSIMD(MATH_SIMD_BEST);
+
+	batch->project(p, x, y, column, depth, n);
+}
+
+void Vec3f_normalize_n(float *x, float *y, float *z, float *lengths, int n)
+{
+	if (!batch)
+		Math_SetSIMD(MATH_SIMD_BEST);
+
+	batch->normalize(x, y, z, lengths, n);
+}
+
+void Vec3f_distance_n(Vec3f point, const float *x, const float *y, const float *z, float *out, int n)
+{
+	if (!batch)
+		Math_SetSIMD(MATH_SIMD_BEST);
+
+	batch->distance(point, x, y, z, out, n);
+}
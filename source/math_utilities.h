@@ -107,6 +107,48 @@ Vec3f Vec3f_crossproduct(Vec3f v1, Vec3f v2);
 float Vec3f_dotproduct(Vec3f v1, Vec3f v2);
 float Vec3f_normalize(Vec3f *v);
 
+/*
+ * batch routines
+ *
+ * these work on n vectors at once, stored as separate x, y and z arrays. the
+ * fastest instruction set the cpu supports is picked on first use, and every
+ * path gives the same results as the scalar one.
+ */
+
+enum {
+	MATH_SIMD_NONE,
+	MATH_SIMD_SSE2,
+	MATH_SIMD_AVX2,
+	MATH_SIMD_BEST = MATH_SIMD_AVX2
+};
+
+/* sprite projection parameters, in map coordinates where y grows southwards */
+typedef struct Projection {
+	Vec2f origin; /* camera position */
+	Vec2f forward; /* unit view direction */
+	float focal; /* distance to the projection plane, in columns */
+	float center; /* column the view direction lands on */
+	float min_depth; /* points closer than this are rejected */
+} Projection;
+
+/* use the best instruction set up to level, returns the one chosen */
+int Math_SetSIMD(int level);
+
+/* get the instruction set in use */
+int Math_GetSIMD(void);
+
+/* transform points by column-major matrix, with w taken as 1 */
+void Vec3f_transform_n(const Mat4f *m, const float *x, const float *y, const float *z, float *ox, float *oy, float *oz, int n);
+
+/* project points to fractional screen columns and depths. rejected points get a depth of 0 */
+void Vec2f_project_n(const Projection *p, const float *x, const float *y, float *column, float *depth, int n);
+
+/* normalize vectors in place, optionally storing their lengths. zero length vectors are left alone */
+void Vec3f_normalize_n(float *x, float *y, float *z, float *lengths, int n);
+
+/* distances from point to vectors */
+void Vec3f_distance_n(Vec3f point, const float *x, const float *y, const float *z, float *out, int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,484 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * fixed point math benchmark
+ *
+ * times the fixed point routines in fixed.c against their float counterparts
+ * over the same inputs, then reports the largest error of each fixed point
+ * routine against libm.
+ *
+ * then times the trig.c lookup tables against libm and reports their largest
+ * error, and times the batch routines in math_utilities.c with every
+ * instruction set the cpu supports, checking that each one matches the scalar
+ * results.
+ *
+ * usage: neurottic_mathbench [-iterations <n>]
+ */
+
+#include "neurottic.h"
+
+#include <SDL3/SDL_main.h>
+
+#define NUM_INPUTS (4096)
+
+typedef struct bench {
+	const char *name;
+	void (*test)(void);
+	void (*ref)(void);
+} bench_t;
+
+typedef struct batch {
+	const char *name;
+	void (*func)(void);
+} batch_t;
+
+/* inputs, the float ones hold the same values as the fixed ones */
+static fixed_t xa[NUM_INPUTS], xb[NUM_INPUTS];
+static angle_t angles[NUM_INPUTS];
+static float fa[NUM_INPUTS], fb[NUM_INPUTS];
+static float fangles[NUM_INPUTS];
+
+/* batch inputs and outputs, the count is odd to exercise the leftovers */
+#define NUM_BATCH (NUM_INPUTS - 3)
+
+static float bx[NUM_INPUTS], by[NUM_INPUTS], bz[NUM_INPUTS];
+static float out[4][NUM_INPUTS];
+static float expected[4][NUM_INPUTS];
+
+static const char *simd_names[] = {"scalar", "sse2", "avx2"};
+
+/* keeps the compiler from throwing the results away */
+static volatile Sint64 sink_fixed;
+static volatile float sink_float;
+
+static Uint32 Random(Uint32 *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static void MakeInputs(void)
+{
+	Uint32 state = 0x4e524f54;
+
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		/* positions within a map, and factors that are never zero */
+		xa[i] = (fixed_t)(Random(&state) % INT_TO_FIXED(128)) - INT_TO_FIXED(64);
+		xb[i] = (fixed_t)(Random(&state) % INT_TO_FIXED(4)) + FRACUNIT / 16;
+		angles[i] = Random(&state) & FINEMASK;
+
+		fa[i] = FIXED_TO_FLOAT(xa[i]);
+		fb[i] = FIXED_TO_FLOAT(xb[i]);
+		fangles[i] = angles[i] * (2.0f * (float)M_PI / FINEANGLES);
+	}
+
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		bx[i] = fa[i];
+		by[i] = fa[NUM_INPUTS - 1 - i];
+		bz[i] = fb[i] - 2.0f;
+	}
+}
+
+/*
+ * benchmarks, each one runs over every input once
+ */
+
+static void Fixed_Mul(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixmul(xa[i], xb[i]);
+	sink_fixed += s;
+}
+
+static void Float_Mul(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fa[i] * fb[i];
+	sink_float += s;
+}
+
+static void Fixed_Div(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixdiv(xa[i], xb[i]);
+	sink_fixed += s;
+}
+
+static void Float_Div(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fa[i] / fb[i];
+	sink_float += s;
+}
+
+static void Fixed_SinCos(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixsin(angles[i]) + fixcos(angles[i]);
+	sink_fixed += s;
+}
+
+static void Float_SinCos(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += SDL_sinf(fangles[i]) + SDL_cosf(fangles[i]);
+	sink_float += s;
+}
+
+static void Fixed_Atan2(void)
+{
+	angle_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixatan2(xa[i], xa[NUM_INPUTS - 1 - i]);
+	sink_fixed += s;
+}
+
+static void Float_Atan2(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += SDL_atan2f(fa[i], fa[NUM_INPUTS - 1 - i]);
+	sink_float += s;
+}
+
+static void Fixed_Sqrt(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixsqrt(xb[i]);
+	sink_fixed += s;
+}
+
+static void Float_Sqrt(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += SDL_sqrtf(fb[i]);
+	sink_float += s;
+}
+
+static void Fixed_Hypot(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixhypot(xa[i], xa[NUM_INPUTS - 1 - i]);
+	sink_fixed += s;
+}
+
+static void Fixed_ApproxDist(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += fixapproxdist(xa[i], xa[NUM_INPUTS - 1 - i]);
+	sink_fixed += s;
+}
+
+static void Float_Hypot(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		float x = fa[i], y = fa[NUM_INPUTS - 1 - i];
+		s += SDL_sqrtf(x * x + y * y);
+	}
+	sink_float += s;
+}
+
+static void Fixed_Rotate(void)
+{
+	fixed_t s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		Vec2x v = {xa[i], xb[i]};
+		v = Vec2x_rotate(v, angles[i]);
+		s += v.x + v.y;
+	}
+	sink_fixed += s;
+}
+
+static void Float_Rotate(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		float sn = SDL_sinf(fangles[i]), cs = SDL_cosf(fangles[i]);
+		s += (fa[i] * cs - fb[i] * sn) + (fa[i] * sn + fb[i] * cs);
+	}
+	sink_float += s;
+}
+
+static const bench_t benches[] = {
+	{"mul", Fixed_Mul, Float_Mul},
+	{"div", Fixed_Div, Float_Div},
+	{"sin+cos", Fixed_SinCos, Float_SinCos},
+	{"atan2", Fixed_Atan2, Float_Atan2},
+	{"sqrt", Fixed_Sqrt, Float_Sqrt},
+	{"hypot", Fixed_Hypot, Float_Hypot},
+	{"approxdist", Fixed_ApproxDist, Float_Hypot},
+	{"rotate", Fixed_Rotate, Float_Rotate}
+};
+
+static double Time(void (*func)(void), int iterations)
+{
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	for (int i = 0; i < iterations; i++)
+		func();
+
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000000000.0 /
+		(double)SDL_GetPerformanceFrequency() / ((double)iterations * NUM_INPUTS);
+}
+
+/*
+ * trig lookup tables
+ */
+
+static void Trig_LutSinCos(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		float sn, cs;
+		Trig_SinCos(fangles[i], &sn, &cs);
+		s += sn + cs;
+	}
+	sink_float += s;
+}
+
+static void Trig_LutTan(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += Trig_Tan(fangles[i]);
+	sink_float += s;
+}
+
+static void Float_Tan(void)
+{
+	float s = 0;
+	for (int i = 0; i < NUM_INPUTS; i++)
+		s += SDL_tanf(fangles[i]);
+	sink_float += s;
+}
+
+static const bench_t trigs[] = {
+	{"sin+cos", Trig_LutSinCos, Float_SinCos},
+	{"tan", Trig_LutTan, Float_Tan}
+};
+
+static void RunTrig(int iterations)
+{
+	double err_sincos = 0, err_tan = 0, err_rcl = 0;
+
+	for (int i = 0; i < ASIZE(trigs); i++)
+	{
+		double lut = Time(trigs[i].test, iterations);
+		double libm = Time(trigs[i].ref, iterations);
+
+		SDL_Log("%-12s table %7.3f ns/op libm %7.3f ns/op (%.2fx)",
+			trigs[i].name, lut, libm, libm / lut);
+	}
+
+	/* sweep a few turns either side of zero */
+	for (int i = -(1 << 20); i < (1 << 20); i++)
+	{
+		float x = i * (float)(4.0 * M_PI / (1 << 20));
+		float s, c;
+
+		Trig_SinCos(x, &s, &c);
+		err_sincos = SDL_max(err_sincos, fabs(s - sin(x)));
+		err_sincos = SDL_max(err_sincos, fabs(c - cos(x)));
+
+		/* tan away from its poles, relative once it grows past 1 */
+		if (fabs(cos(x)) > 0.01)
+			err_tan = SDL_max(err_tan, fabs(Trig_Tan(x) - tan(x)) / SDL_max(fabs(tan(x)), 1.0));
+	}
+
+#ifdef NEUROTTIC_TRIG_LUT
+	for (int i = 0; i < TRIG_RCL_TABLE_SIZE; i++)
+		err_rcl = SDL_max(err_rcl, fabs(trig_rcl_cos[i] - cos(i * 2.0 * M_PI / TRIG_RCL_TABLE_SIZE) * 1024.0));
+#endif
+
+	SDL_Log("max error: table sin/cos %g, tan %g, raycastlib cos %.3f units",
+		err_sincos, err_tan, err_rcl);
+}
+
+/*
+ * batch routines
+ */
+
+static void Batch_Transform(void)
+{
+	static const Mat4f m = {.m = {
+		{0.8f, 0.6f, 0, 0},
+		{-0.6f, 0.8f, 0, 0},
+		{0, 0, 1, 0},
+		{12.5f, -3.25f, 0.5f, 1}
+	}};
+
+	Vec3f_transform_n(&m, bx, by, bz, out[0], out[1], out[2], NUM_BATCH);
+}
+
+static void Batch_Project(void)
+{
+	static const Projection p = {{1.5f, -2.5f}, {0.6f, -0.8f}, 320.0f, 320.0f, 0.1f};
+
+	Vec2f_project_n(&p, bx, by, out[0], out[1], NUM_BATCH);
+}
+
+static void Batch_Normalize(void)
+{
+	SDL_memcpy(out[0], bx, sizeof(bx));
+	SDL_memcpy(out[1], by, sizeof(by));
+	SDL_memcpy(out[2], bz, sizeof(bz));
+	Vec3f_normalize_n(out[0], out[1], out[2], out[3], NUM_BATCH);
+}
+
+static void Batch_Distance(void)
+{
+	static const Vec3f point = {1.5f, -2.5f, 0.5f};
+
+	Vec3f_distance_n(point, bx, by, bz, out[0], NUM_BATCH);
+}
+
+static const batch_t batches[] = {
+	{"transform", Batch_Transform},
+	{"project", Batch_Project},
+	{"normalize", Batch_Normalize},
+	{"distance", Batch_Distance}
+};
+
+static void RunBatches(int iterations)
+{
+	int best = Math_SetSIMD(MATH_SIMD_BEST);
+
+	for (int i = 0; i < ASIZE(batches); i++)
+	{
+		for (int level = MATH_SIMD_NONE; level <= best; level++)
+		{
+			SDL_bool match = SDL_TRUE;
+			double ns;
+
+			if (Math_SetSIMD(level) != level)
+				continue;
+
+			SDL_memset(out, 0, sizeof(out));
+			ns = Time(batches[i].func, iterations);
+
+			/* scalar runs first and gives the expected results */
+			if (level == MATH_SIMD_NONE)
+				SDL_memcpy(expected, out, sizeof(out));
+			else
+				match = SDL_memcmp(expected, out, sizeof(out)) == 0;
+
+			SDL_Log("%-12s %-6s %7.3f ns/op%s", batches[i].name, simd_names[level], ns,
+				match ? "" : " MISMATCH");
+		}
+	}
+
+	Math_SetSIMD(MATH_SIMD_BEST);
+}
+
+/*
+ * accuracy against libm
+ */
+
+static void CheckErrors(void)
+{
+	double err_sin = 0, err_atan2 = 0, err_sqrt = 0, err_hypot = 0, err_approx = 0;
+
+	for (int a = 0; a < FINEANGLES; a++)
+	{
+		double r = a * 2.0 * M_PI / FINEANGLES;
+		err_sin = SDL_max(err_sin, fabs(FIXED_TO_FLOAT(fixsin(a)) - sin(r)));
+		err_sin = SDL_max(err_sin, fabs(FIXED_TO_FLOAT(fixcos(a)) - cos(r)));
+	}
+
+	for (int i = 0; i < NUM_INPUTS; i++)
+	{
+		fixed_t x = xa[NUM_INPUTS - 1 - i], y = xa[i];
+		double dx = FIXED_TO_FLOAT(x), dy = FIXED_TO_FLOAT(y);
+		double angle = atan2(dy, dx) * FINEANGLES / (2.0 * M_PI);
+		double diff = fmod(fixatan2(y, x) - angle + FINEANGLES * 1.5, FINEANGLES) - FINEANGLES / 2;
+		double length = sqrt(dx * dx + dy * dy);
+
+		err_atan2 = SDL_max(err_atan2, fabs(diff));
+		err_sqrt = SDL_max(err_sqrt, fabs(FIXED_TO_FLOAT(fixsqrt(xb[i])) / sqrt(FIXED_TO_FLOAT(xb[i])) - 1));
+
+		if (length > 0)
+		{
+			err_hypot = SDL_max(err_hypot, fabs(FIXED_TO_FLOAT(fixhypot(x, y)) / length - 1));
+			err_approx = SDL_max(err_approx, fabs(FIXED_TO_FLOAT(fixapproxdist(x, y)) / length - 1));
+		}
+	}
+
+	SDL_Log("max error: sin/cos %g, atan2 %.3f fine angles, sqrt %.5f%%, hypot %.5f%%, approxdist %.2f%%",
+		err_sin, err_atan2, err_sqrt * 100, err_hypot * 100, err_approx * 100);
+}
+
+int main(int argc, char **argv)
+{
+	int iterations = 2000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (SDL_strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+			iterations = SDL_atoi(argv[++i]);
+	}
+
+	iterations = SDL_max(iterations, 1);
+
+	Trig_Init();
+	MakeInputs();
+
+	SDL_Log("%d iterations over %d inputs", iterations, NUM_INPUTS);
+
+	for (int i = 0; i < ASIZE(benches); i++)
+	{
+		double fixed = Time(benches[i].test, iterations);
+		double flt = Time(benches[i].ref, iterations);
+
+		SDL_Log("%-12s fixed %7.3f ns/op float %7.3f ns/op (%.2fx)",
+			benches[i].name, fixed, flt, flt / fixed);
+	}
+
+	CheckErrors();
+
+	RunTrig(iterations);
+
+	RunBatches(iterations);
+
+	return 0;
+}
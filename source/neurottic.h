@@ -48,9 +48,21 @@ extern "C" {
 /* console */
 #include "console.h"
 
+/* dark war data tables */
+#include "darkwar.h"
+
+/* demo recording and playback */
+#include "demo.h"
+
 /* filesystem */
 #include "filesystem.h"
 
+/* fixed point math */
+#include "fixed.h"
+
+/* game */
+#include "game.h"
+
 /* logging */
 #include "logging.h"
 
@@ -66,12 +78,21 @@ extern "C" {
 /* math utilities */
 #include "math_utilities.h"
 
+/* frame timing */
+#include "perf.h"
+
+/* profiler */
+#include "profiler.h"
+
 /* renderer */
 #include "renderer.h"
 
 /* rlew compression */
 #include "rlew.h"
 
+/* trigonometry tables */
+#include "trig.h"
+
 #ifdef __cplusplus
 }
 #endif
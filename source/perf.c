@@ -0,0 +1,268 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "neurottic.h"
+
+/*
+ *
+ * globals
+ *
+ */
+
+static const char *section_names[PERF_NUM_SECTIONS] = {
+	[PERF_SIMULATION] = "sim",
+	[PERF_RAYCAST] = "3d",
+	[PERF_2D] = "2d",
+	[PERF_CONVERT] = "cvt",
+	[PERF_PRESENT] = "pre"
+};
+
+static double to_ms = 0;
+static Uint64 last_mark = 0;
+static perf_frame_t current = {};
+
+/* history ring */
+static perf_frame_t history[PERF_HISTORY] = {};
+static int history_head = 0;
+
+/* one second accumulation window */
+static Uint64 window_start = 0;
+static int window_frames = 0;
+static perf_frame_t window_sum = {};
+static perf_summary_t summary = {};
+static SDL_bool summary_changed = SDL_FALSE;
+
+/* heap tracking, every block is prefixed with its size, padded to keep
+ * the alignment of the real allocator */
+typedef union heap_block {
+	size_t size;
+	Uint8 pad[16];
+} heap_block_t;
+
+static SDL_malloc_func real_malloc = NULL;
+static SDL_calloc_func real_calloc = NULL;
+static SDL_realloc_func real_realloc = NULL;
+static SDL_free_func real_free = NULL;
+static SDL_SpinLock heap_lock = 0;
+static Uint64 heap_bytes = 0;
+static SDL_bool heap_tracked = SDL_FALSE;
+
+/*
+ *
+ * private
+ *
+ */
+
+/* a spinlock, as a mutex would have to be allocated through the wrappers */
+static void heap_count(size_t add, size_t remove)
+{
+	SDL_LockSpinlock(&heap_lock);
+	heap_bytes += add;
+	heap_bytes -= remove;
+	SDL_UnlockSpinlock(&heap_lock);
+}
+
+static void *SDLCALL heap_malloc(size_t size)
+{
+	heap_block_t *block = real_malloc(sizeof(heap_block_t) + size);
+	if (!block)
+		return NULL;
+
+	block->size = size;
+	heap_count(size, 0);
+
+	return block + 1;
+}
+
+static void *SDLCALL heap_calloc(size_t nmemb, size_t size)
+{
+	heap_block_t *block;
+
+	if (size && nmemb > (SDL_SIZE_MAX - sizeof(heap_block_t)) / size)
+		return NULL;
+
+	block = real_calloc(1, sizeof(heap_block_t) + nmemb * size);
+	if (!block)
+		return NULL;
+
+	block->size = nmemb * size;
+	heap_count(block->size, 0);
+
+	return block + 1;
+}
+
+static void *SDLCALL heap_realloc(void *mem, size_t size)
+{
+	heap_block_t *block;
+	size_t old_size;
+
+	if (!mem)
+		return heap_malloc(size);
+
+	block = (heap_block_t *)mem - 1;
+	old_size = block->size;
+
+	block = real_realloc(block, sizeof(heap_block_t) + size);
+	if (!block)
+		return NULL;
+
+	block->size = size;
+	heap_count(size, old_size);
+
+	return block + 1;
+}
+
+static void SDLCALL heap_free(void *mem)
+{
+	heap_block_t *block;
+
+	if (!mem)
+		return;
+
+	block = (heap_block_t *)mem - 1;
+	heap_count(0, block->size);
+	real_free(block);
+}
+
+/*
+ *
+ * public
+ *
+ */
+
+void Perf_BeginFrame(void)
+{
+	if (to_ms == 0)
+		to_ms = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+	last_mark = SDL_GetPerformanceCounter();
+	SDL_memset(&current, 0, sizeof(current));
+
+	if (window_start == 0)
+		window_start = last_mark;
+}
+
+void Perf_Mark(perf_section_t section)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (section < 0 || section >= PERF_NUM_SECTIONS || last_mark == 0)
+		return;
+
+	current.sections[section] += (float)((now - last_mark) * to_ms);
+	last_mark = now;
+}
+
+void Perf_EndFrame(void)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (last_mark == 0)
+		return;
+
+	/* add up sections */
+	current.total = 0;
+	for (int i = 0; i < PERF_NUM_SECTIONS; i++)
+		current.total += current.sections[i];
+
+	/* push into history */
+	history[history_head] = current;
+	history_head = (history_head + 1) % PERF_HISTORY;
+
+	/* accumulate into window */
+	window_frames++;
+	window_sum.total += current.total;
+	for (int i = 0; i < PERF_NUM_SECTIONS; i++)
+		window_sum.sections[i] += current.sections[i];
+
+	/* publish the window once per second */
+	if ((now - window_start) * to_ms >= 1000.0)
+	{
+		summary.fps = window_frames;
+		summary.total = window_sum.total / window_frames;
+		for (int i = 0; i < PERF_NUM_SECTIONS; i++)
+			summary.sections[i] = window_sum.sections[i] / window_frames;
+
+		summary_changed = SDL_TRUE;
+
+		window_start = now;
+		window_frames = 0;
+		SDL_memset(&window_sum, 0, sizeof(window_sum));
+	}
+
+	last_mark = 0;
+}
+
+const perf_frame_t *Perf_GetHistory(int *head)
+{
+	if (head) *head = history_head;
+	return history;
+}
+
+SDL_bool Perf_GetSummary(perf_summary_t *out)
+{
+	SDL_bool changed = summary_changed;
+
+	if (out) *out = summary;
+	summary_changed = SDL_FALSE;
+
+	return changed;
+}
+
+const char *Perf_GetSectionName(perf_section_t section)
+{
+	if (section < 0 || section >= PERF_NUM_SECTIONS)
+		return NULL;
+
+	return section_names[section];
+}
+
+int Perf_TrackHeap(void)
+{
+	if (heap_tracked)
+		return 0;
+
+	SDL_GetOriginalMemoryFunctions(&real_malloc, &real_calloc, &real_realloc, &real_free);
+
+	if (SDL_SetMemoryFunctions(heap_malloc, heap_calloc, heap_realloc, heap_free) != 0)
+		return -1;
+
+	heap_tracked = SDL_TRUE;
+
+	return 0;
+}
+
+Sint64 Perf_GetHeapUsage(void)
+{
+	Uint64 bytes;
+
+	if (!heap_tracked)
+		return -1;
+
+	SDL_LockSpinlock(&heap_lock);
+	bytes = heap_bytes;
+	SDL_UnlockSpinlock(&heap_lock);
+
+	return (Sint64)bytes;
+}
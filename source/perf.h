@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _PERF_H_
+#define _PERF_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * frame timing statistics
+ *
+ * each frame is split into sequential sections. Perf_Mark() attributes the
+ * time since the previous mark to the given section, so the sections of a
+ * frame always add up to its total work time.
+ */
+
+#include <SDL3/SDL.h>
+
+#define PERF_HISTORY (128)
+
+typedef enum perf_section {
+	PERF_SIMULATION,
+	PERF_RAYCAST,
+	PERF_2D,
+	PERF_CONVERT,
+	PERF_PRESENT,
+	PERF_NUM_SECTIONS
+} perf_section_t;
+
+typedef struct perf_frame {
+	float total;
+	float sections[PERF_NUM_SECTIONS];
+} perf_frame_t;
+
+typedef struct perf_summary {
+	int fps;
+	float total;
+	float sections[PERF_NUM_SECTIONS];
+} perf_summary_t;
+
+/* start timing a new frame */
+void Perf_BeginFrame(void);
+
+/* attribute time since the last mark to a section */
+void Perf_Mark(perf_section_t section);
+
+/* finish timing the current frame */
+void Perf_EndFrame(void);
+
+/* get frame history ring (all times are in milliseconds)
+ *
+ * head is the index of the oldest frame in the ring.
+ */
+const perf_frame_t *Perf_GetHistory(int *head);
+
+/* get per-section averages over the last second
+ *
+ * returns SDL_TRUE if the summary changed since the last call.
+ */
+SDL_bool Perf_GetSummary(perf_summary_t *summary);
+
+/* get the name of a section */
+const char *Perf_GetSectionName(perf_section_t section);
+
+/*
+ * heap usage
+ *
+ * Perf_TrackHeap() wraps SDL's allocators to count the bytes allocated
+ * through them. it has to be called before anything is allocated with
+ * SDL_malloc(), as blocks from the original allocator can't be freed by
+ * the wrappers. that includes SDL_RunApp(), so it's called from main()
+ * rather than from SDL_AppInit().
+ */
+
+/* start counting heap usage */
+int Perf_TrackHeap(void);
+
+/* get number of bytes allocated through SDL, or -1 if not tracking */
+Sint64 Perf_GetHeapUsage(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PERF_H_ */
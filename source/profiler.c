@@ -0,0 +1,245 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "neurottic.h"
+
+#ifdef NEUROTTIC_PROFILER
+
+/*
+ *
+ * types & defines
+ *
+ */
+
+#define PROFILE_RING_SIZE (65536)
+#define PROFILE_MAX_THREADS (16)
+
+typedef struct profile_event {
+	const char *name;
+	Uint64 start;
+	Uint64 end;
+} profile_event_t;
+
+typedef struct profile_thread {
+	int index;
+	Uint64 num_events;
+	profile_event_t events[PROFILE_RING_SIZE];
+} profile_thread_t;
+
+/*
+ *
+ * globals
+ *
+ */
+
+static Uint64 origin = 0;
+static SDL_SpinLock threads_lock = 0;
+static int num_threads = 0;
+static profile_thread_t *threads[PROFILE_MAX_THREADS] = {};
+
+/* each thread only ever writes into its own buffer */
+static __thread profile_thread_t *this_thread = NULL;
+static __thread SDL_bool this_thread_failed = SDL_FALSE;
+
+/*
+ *
+ * private
+ *
+ */
+
+static profile_thread_t *get_thread(void)
+{
+	profile_thread_t *thread;
+
+	if (this_thread || this_thread_failed)
+		return this_thread;
+
+	thread = SDL_calloc(1, sizeof(profile_thread_t));
+	if (!thread)
+	{
+		this_thread_failed = SDL_TRUE;
+		return NULL;
+	}
+
+	SDL_LockSpinlock(&threads_lock);
+
+	if (num_threads < PROFILE_MAX_THREADS)
+	{
+		thread->index = num_threads;
+		threads[num_threads++] = thread;
+	}
+	else
+	{
+		SDL_free(thread);
+		thread = NULL;
+	}
+
+	SDL_UnlockSpinlock(&threads_lock);
+
+	this_thread = thread;
+	this_thread_failed = thread == NULL;
+
+	return thread;
+}
+
+/*
+ *
+ * public
+ *
+ */
+
+void Profiler_BeginZone(profile_zone_t *zone, const char *name)
+{
+	zone->name = name;
+	zone->start = SDL_GetPerformanceCounter();
+}
+
+void Profiler_EndZone(profile_zone_t *zone)
+{
+	Uint64 end = SDL_GetPerformanceCounter();
+	profile_thread_t *thread = get_thread();
+	profile_event_t *event;
+
+	if (!thread)
+		return;
+
+	event = &thread->events[thread->num_events % PROFILE_RING_SIZE];
+	event->name = zone->name;
+	event->start = zone->start;
+	event->end = end;
+
+	thread->num_events++;
+}
+
+int Profiler_Init(void)
+{
+	origin = SDL_GetPerformanceCounter();
+	return 0;
+}
+
+void Profiler_Quit(void)
+{
+	SDL_LockSpinlock(&threads_lock);
+
+	for (int i = 0; i < num_threads; i++)
+	{
+		SDL_free(threads[i]);
+		threads[i] = NULL;
+	}
+
+	num_threads = 0;
+
+	SDL_UnlockSpinlock(&threads_lock);
+
+	/* only the calling thread can forget its own buffer */
+	this_thread = NULL;
+	this_thread_failed = SDL_FALSE;
+}
+
+void Profiler_Clear(void)
+{
+	SDL_LockSpinlock(&threads_lock);
+
+	for (int i = 0; i < num_threads; i++)
+		threads[i]->num_events = 0;
+
+	SDL_UnlockSpinlock(&threads_lock);
+}
+
+int Profiler_Dump(const char *filename)
+{
+	SDL_IOStream *io;
+	double to_us = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+	Uint64 num_written = 0;
+	profile_thread_t *dump_threads[PROFILE_MAX_THREADS];
+	int num_dump_threads;
+
+	if (!filename)
+		return LogError("Profiler_Dump(): NULL pointer passed as filename");
+
+	io = FS_OpenFile(filename, "wb", FS_PATH_PREF);
+	if (!io)
+		return LogError("Profiler_Dump(): Couldn't open \"%s\" for writing", filename);
+
+	SDL_IOprintf(io, "{\"traceEvents\":[\n");
+
+	/* don't make threads starting their first zone spin while writing the file,
+	 * the buffers themselves are only freed by Profiler_Quit() */
+	SDL_LockSpinlock(&threads_lock);
+	num_dump_threads = num_threads;
+	SDL_memcpy(dump_threads, threads, num_threads * sizeof(profile_thread_t *));
+	SDL_UnlockSpinlock(&threads_lock);
+
+	for (int i = 0; i < num_dump_threads; i++)
+	{
+		profile_thread_t *thread = dump_threads[i];
+		Uint64 first = 0;
+
+		SDL_IOprintf(io, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+			num_written++ ? ",\n" : "", thread->index, thread->index);
+
+		/* only the newest events survive in the ring */
+		if (thread->num_events > PROFILE_RING_SIZE)
+			first = thread->num_events - PROFILE_RING_SIZE;
+
+		for (Uint64 e = first; e < thread->num_events; e++)
+		{
+			profile_event_t *event = &thread->events[e % PROFILE_RING_SIZE];
+
+			SDL_IOprintf(io, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				event->name, thread->index,
+				(double)(event->start - origin) * to_us,
+				(double)(event->end - event->start) * to_us);
+		}
+	}
+
+	SDL_IOprintf(io, "\n]}\n");
+	SDL_CloseIO(io);
+
+	return Log("Wrote profile to \"%s\"", filename);
+}
+
+#else
+
+int Profiler_Init(void)
+{
+	return 0;
+}
+
+void Profiler_Quit(void)
+{
+
+}
+
+void Profiler_Clear(void)
+{
+
+}
+
+int Profiler_Dump(const char *filename)
+{
+	return LogError("Profiler_Dump(): Profiler support was not compiled in");
+}
+
+#endif /* NEUROTTIC_PROFILER */
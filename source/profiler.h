@@ -0,0 +1,88 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * neurottic profiler
+ *
+ * PROFILE_ZONE(name) opens a zone that is closed when the enclosing scope is
+ * left, so zones nest naturally with the call graph. zones are recorded into a
+ * ring buffer owned by the calling thread, and can be written out in the
+ * chrome trace event format for viewing in a trace viewer.
+ *
+ * the zone macros compile to nothing unless NEUROTTIC_PROFILER is defined.
+ */
+
+#include <SDL3/SDL.h>
+
+/* startup profiler */
+int Profiler_Init(void);
+
+/* shutdown profiler and free all thread buffers */
+void Profiler_Quit(void);
+
+/* discard all recorded zones */
+void Profiler_Clear(void);
+
+/* write all recorded zones to a chrome trace event json file in the pref dir */
+int Profiler_Dump(const char *filename);
+
+#ifdef NEUROTTIC_PROFILER
+
+typedef struct profile_zone {
+	const char *name;
+	Uint64 start;
+} profile_zone_t;
+
+void Profiler_BeginZone(profile_zone_t *zone, const char *name);
+void Profiler_EndZone(profile_zone_t *zone);
+
+#define _PROFILE_CONCAT2(a, b) a##b
+#define _PROFILE_CONCAT(a, b) _PROFILE_CONCAT2(a, b)
+#define _PROFILE_ZONE_VAR _PROFILE_CONCAT(_profile_zone_, __LINE__)
+
+/* open zone until the end of the current scope */
+#define PROFILE_ZONE(name) \
+	profile_zone_t _PROFILE_ZONE_VAR __attribute__((cleanup(Profiler_EndZone))); \
+	Profiler_BeginZone(&_PROFILE_ZONE_VAR, name)
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif
+
+/* open zone named after the current function */
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PROFILER_H_ */
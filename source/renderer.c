@@ -22,16 +22,109 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_R
 #include "neurottic.h"
 
+#define OVERLAY_X (8)
+#define OVERLAY_Y (8)
+#define OVERLAY_WIDTH (48 * 8)
+#define OVERLAY_GRAPH_HEIGHT (40)
+#define OVERLAY_GRAPH_MS (40.0f)
+
+enum {
+	OVERLAY_LINE_FPS,
+	OVERLAY_LINE_SECTIONS,
+	OVERLAY_LINE_CACHE,
+	OVERLAY_LINE_HEAP,
+	OVERLAY_LINE_MAP,
+	OVERLAY_NUM_LINES
+};
+
 static Uint8 global_palette[768] = {};
 
+/* closest palette index of each 15-bit color, 5 bits per channel */
+static Uint8 inverse_palette[32768];
+
+/* overlay colors, matched to the current palette */
+static Uint8 overlay_background = 0;
+static Uint8 overlay_graph = 0;
+static Uint8 overlay_budget = 0;
+
+/* overlay text is only reformatted when the values behind it change */
+static char overlay_lines[OVERLAY_NUM_LINES][80] = {};
+
+/* cvars */
+static cvar_t *perf_overlay = NULL;
+
+int R_Init_REAL(void);
+void R_Quit_REAL(void);
+
+int R_Init(void)
+{
+	perf_overlay = Console_RegisterCvar("perf_overlay", "0", CVAR_BOOL, NULL);
+
+	return R_Init_REAL();
+}
+
+void R_Quit(void)
+{
+	R_Quit_REAL();
+
+	perf_overlay = NULL;
+}
+
 void R_SetPalette_REAL(Uint8 *palette);
 
+/* brute force search for every 15-bit color, once per palette */
+static void R_BuildInversePalette(void)
+{
+	PROFILE_FUNCTION();
+
+	int pal[256][3];
+
+	for (int i = 0; i < 256; i++)
+	{
+		pal[i][0] = global_palette[i * 3];
+		pal[i][1] = global_palette[i * 3 + 1];
+		pal[i][2] = global_palette[i * 3 + 2];
+	}
+
+	for (int c = 0; c < 32768; c++)
+	{
+		/* center of the 5-bit cell, scaled back up to 8 bits */
+		int r = ((c >> 10) << 3) | (c >> 12);
+		int g = (((c >> 5) & 31) << 3) | ((c >> 7) & 7);
+		int b = ((c & 31) << 3) | ((c >> 2) & 7);
+		int best_index = 0;
+		int best_dist = SDL_MAX_SINT32;
+
+		for (int i = 0; i < 256 && best_dist; i++)
+		{
+			int dr = r - pal[i][0];
+			int dg = g - pal[i][1];
+			int db = b - pal[i][2];
+			int dist = dr * dr + dg * dg + db * db;
+
+			if (dist < best_dist)
+			{
+				best_index = i;
+				best_dist = dist;
+			}
+		}
+
+		inverse_palette[c] = (Uint8)best_index;
+	}
+}
+
 void R_SetPalette(Uint8 *palette)
 {
 	SDL_memcpy(global_palette, palette, 768);
+	R_BuildInversePalette();
 	R_SetPalette_REAL(global_palette);
+
+	overlay_background = R_FindColor(0x00, 0x00, 0x00);
+	overlay_graph = R_FindColor(0x00, 0xFF, 0x00);
+	overlay_budget = R_FindColor(0xFF, 0x00, 0x00);
 }
 
 void R_SetSurfacePalette(SDL_Surface *surface, Uint8 *palette)
@@ -94,7 +187,7 @@ SDL_Surface *R_SurfaceFromPicIO(SDL_IOStream *io, SDL_bool closeio)
 	Uint8 *src = (Uint8 *)alloca(w);
 	if (!src)
 	{
-		LogError("R_SurfaceFromPicIO(): alloca() failed with %zu bytes", w);
+		LogError("R_SurfaceFromPicIO(): alloca() failed with %d bytes", w);
 		SDL_DestroySurface(surface);
 		return NULL;
 	}
@@ -206,27 +299,136 @@ SDL_Surface *R_SurfaceFromFontIO(SDL_IOStream *io, SDL_bool closeio)
 /* draw console */
 void R_DrawConsole(void)
 {
-	int num_lines;
+	SDL_Surface *screen = R_GetScreenSurface();
+	int num_lines, first;
+	int visible_lines = Console_GetVisibleLines();
 	char *input = Console_GetInputLine();
-	char **lines = Console_GetLines(&num_lines);
-	int y = 0;
+
+	Console_Lock();
+
+	/* newest lines that fit above the input line, minus scrollback */
+	num_lines = Console_GetNumLines() - Console_GetScroll();
+	first = SDL_max(num_lines - visible_lines, 0);
 
 	/* draw lines */
-	for (int i = 0; i < num_lines; i++)
+	for (int i = first, y = 0; i < num_lines; i++, y += 8)
+		R_DrawText(0, y, 0xFF, Console_GetLine(i));
+
+	Console_Unlock();
+
+	/* draw input line */
+	R_DrawString(0, screen->h - 8, 0xFF, input);
+}
+
+/* draw performance overlay */
+void R_DrawOverlay(void)
+{
+	static SDL_bool formatted = SDL_FALSE;
+	static lm_stats_t last_stats;
+	static int last_allocs;
+	static Sint64 last_heap;
+	static int last_map;
+	perf_summary_t summary;
+	lm_stats_t stats;
+	int allocs, map, head, y;
+	Sint64 heap;
+	const perf_frame_t *history;
+
+	if (!perf_overlay || !perf_overlay->value_int)
+		return;
+
+	/* frame times are published once per second */
+	if (Perf_GetSummary(&summary) || !formatted)
 	{
-		if (lines[i])
+		int len = 0;
+
+		SDL_snprintf(overlay_lines[OVERLAY_LINE_FPS], sizeof(overlay_lines[0]),
+			"fps %d  frame %.2f ms", summary.fps, summary.total);
+
+		for (int i = 0; i < PERF_NUM_SECTIONS; i++)
 		{
-			R_DrawString(0, y, 0xFF, lines[i]);
-			y += 8;
+			len += SDL_snprintf(overlay_lines[OVERLAY_LINE_SECTIONS] + len,
+				sizeof(overlay_lines[0]) - len, "%s %.2f ",
+				Perf_GetSectionName(i), summary.sections[i]);
 
-			/* leave room for input line */
-			if (y >= RENDER_HEIGHT - 8)
+			if (len >= sizeof(overlay_lines[0]))
 				break;
 		}
 	}
 
-	/* draw input line */
-	R_DrawString(0, RENDER_HEIGHT - 8, 0xFF, input);
+	/* lump and pic cache */
+	LM_GetStats(&stats);
+	if (SDL_memcmp(&stats, &last_stats, sizeof(stats)) != 0 || !formatted)
+	{
+		Uint32 pic_lookups = stats.pic_hits + stats.pic_misses;
+		Uint32 lump_hits = stats.lump_lookups - stats.lump_misses;
+
+		SDL_snprintf(overlay_lines[OVERLAY_LINE_CACHE], sizeof(overlay_lines[0]),
+			"lumps %u/%u found  pics %u/%u hit (%d cached)",
+			lump_hits, stats.lump_lookups, stats.pic_hits, pic_lookups,
+			stats.num_cached_pics);
+
+		last_stats = stats;
+	}
+
+	/* heap */
+	allocs = SDL_GetNumAllocations();
+	heap = Perf_GetHeapUsage();
+	if (allocs != last_allocs || heap != last_heap || !formatted)
+	{
+		if (heap < 0)
+			SDL_snprintf(overlay_lines[OVERLAY_LINE_HEAP], sizeof(overlay_lines[0]),
+				"heap %d allocations", allocs);
+		else
+			SDL_snprintf(overlay_lines[OVERLAY_LINE_HEAP], sizeof(overlay_lines[0]),
+				"heap %.2f MB in %d allocations", heap / (1024.0 * 1024.0), allocs);
+
+		last_allocs = allocs;
+		last_heap = heap;
+	}
+
+	/* map */
+	map = MS_GetCurrentMap();
+	if (map != last_map || !formatted)
+	{
+		if (map < 0)
+			SDL_snprintf(overlay_lines[OVERLAY_LINE_MAP], sizeof(overlay_lines[0]), "no map loaded");
+		else
+			SDL_snprintf(overlay_lines[OVERLAY_LINE_MAP], sizeof(overlay_lines[0]), "map %02d %s", map, MS_GetMapName(map));
+
+		last_map = map;
+	}
+
+	formatted = SDL_TRUE;
+
+	/* background */
+	R_DrawRect(OVERLAY_X - 4, OVERLAY_Y - 4,
+		OVERLAY_WIDTH + 8, OVERLAY_NUM_LINES * 8 + OVERLAY_GRAPH_HEIGHT + 12,
+		overlay_background);
+
+	/* text */
+	y = OVERLAY_Y;
+	for (int i = 0; i < OVERLAY_NUM_LINES; i++)
+	{
+		R_DrawText(OVERLAY_X, y, 0xFF, overlay_lines[i]);
+		y += 8;
+	}
+
+	/* frame time graph, oldest frame on the left */
+	y += 4;
+	history = Perf_GetHistory(&head);
+	for (int i = 0; i < PERF_HISTORY; i++)
+	{
+		float total = history[(head + i) % PERF_HISTORY].total;
+		int h = (int)(clampf(total / OVERLAY_GRAPH_MS, 0, 1) * OVERLAY_GRAPH_HEIGHT);
+
+		if (h > 0)
+			R_DrawRect(OVERLAY_X + i * 2, y + OVERLAY_GRAPH_HEIGHT - h, 2, h, overlay_graph);
+	}
+
+	/* tick budget */
+	R_DrawRect(OVERLAY_X, y + OVERLAY_GRAPH_HEIGHT - (int)((1000.0f / RENDER_HZ) / OVERLAY_GRAPH_MS * OVERLAY_GRAPH_HEIGHT),
+		PERF_HISTORY * 2, 1, overlay_budget);
 }
 
 /* find closest approximation of RGB color in the indexed palette */
@@ -256,3 +458,9 @@ Uint8 R_FindColor(Uint8 r, Uint8 g, Uint8 b)
 
 	return (Uint8)best_index;
 }
+
+/* find approximation of RGB color in the indexed palette, through a 15-bit lookup table */
+Uint8 R_LookupColor(Uint8 r, Uint8 g, Uint8 b)
+{
+	return inverse_palette[((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3)];
+}
@@ -29,10 +29,20 @@ SOFTWARE.
 extern "C" {
 #endif
 
+/* default screen resolution, changed at runtime with r_width and r_height */
 #define RENDER_WIDTH (640)
 #define RENDER_HEIGHT (480)
 #define RENDER_HZ (35)
 
+/* limits of the screen resolution */
+#define MIN_RENDER_WIDTH (320)
+#define MIN_RENDER_HEIGHT (200)
+#define MAX_RENDER_WIDTH (1920)
+#define MAX_RENDER_HEIGHT (1440)
+
+/* largest r_scale, the 3D view is drawn at 1/r_scale of the screen resolution */
+#define MAX_RENDER_SCALE (4)
+
 typedef struct font {
 	int width;
 	int height;
@@ -51,33 +61,79 @@ void R_Clear(Uint8 color);
 /* draw scene */
 int R_Draw(void);
 
+typedef struct ray_stats {
+	int hits;
+	Uint32 steps; /* summed over all columns, only counted in benchmark builds */
+	Uint32 max_column_steps;
+} ray_stats_t;
+
+/* cast the rays of the current view without drawing anything */
+void R_CastRays(ray_stats_t *stats);
+
+/* setup renderer state for the currently loaded map */
+int R_NewMap(void);
+
 /* draw filled rect */
 int R_DrawRect(int x, int y, int w, int h, Uint8 color);
 
-/* draw surface */
+/* draw surface scaled to w x h, skipping its color key. the opaque runs of
+ * a keyed surface are built on its first draw and kept with the surface, so
+ * its pixels shouldn't change in place after that */
 int R_DrawSurface(int x, int y, int w, int h, SDL_Surface *surface);
 
+/* draw 8-bit surface blended over the screen, alpha goes from 0 (invisible) to
+ * 1 (opaque) and is rounded to r_blend_levels steps */
+int R_DrawSurfaceBlended(int x, int y, int w, int h, SDL_Surface *surface, float alpha);
+
 /* draw console */
 void R_DrawConsole(void);
 
+/* draw performance overlay, if enabled with the perf_overlay cvar */
+void R_DrawOverlay(void);
+
 /* flip to visible screen */
 void R_Flip(void);
 
+/* wait for the display when flipping */
+void R_SetVSync(SDL_bool enable);
+
+/* check if waiting for the display when flipping */
+SDL_bool R_GetVSync(void);
+
 /* set palette colors */
 void R_SetPalette(Uint8 *palette);
 
+/* blend the displayed palette toward r,g,b by amount (0 to 1), for flashes and
+ * fades. only the 256 output colors are rebuilt, the screen isn't touched */
+void R_SetPaletteBlend(Uint8 r, Uint8 g, Uint8 b, float amount);
+
 /* set palette on SDL_Surface */
 void R_SetSurfacePalette(SDL_Surface *surface, Uint8 *palette);
 
-/* set render position */
+/* set render position, in map tiles */
 void R_SetPosition(float x, float y, float z);
 
-/* set render angles */
+/* set render angles, in degrees (yaw 0 faces east, 90 faces north) */
 void R_SetAngles(float x, float y, float z);
 
+/* set render position and yaw from the fixed point game simulation */
+void R_SetView(fixed_t x, fixed_t y, fixed_t z, angle_t angle);
+
+/* get 8-bit surface that everything is drawn into */
+SDL_Surface *R_GetScreenSurface(void);
+
+/* get height of the screen surface, or 0 if there is none. safe to call from any thread */
+int R_GetScreenHeight(void);
+
+/* get resolution the 3D view is drawn at, before it's scaled up to the screen */
+void R_GetViewSize(int *width, int *height);
+
 /* draw string at x,y with color */
 void R_DrawString(int x, int y, Uint8 color, const char *fmt, ...);
 
+/* draw unformatted text at x,y with color */
+void R_DrawText(int x, int y, Uint8 color, const char *text);
+
 /* create SDL_Surface from WAD pic */
 SDL_Surface *R_SurfaceFromPicIO(SDL_IOStream *io, SDL_bool closeio);
 
@@ -87,6 +143,10 @@ SDL_Surface *R_SurfaceFromFontIO(SDL_IOStream *io, SDL_bool closeio);
 /* find closest approximation of RGB color in indexed palette */
 Uint8 R_FindColor(Uint8 r, Uint8 g, Uint8 b);
 
+/* find approximation of RGB color in indexed palette, through a 15-bit lookup
+ * table built by R_SetPalette(). cheap enough to build other tables with */
+Uint8 R_LookupColor(Uint8 r, Uint8 g, Uint8 b);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,14 +22,130 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#define LOG_CATEGORY LOG_CATEGORY_R
 #include "neurottic.h"
 
 #include "font8x8.h"
 
+/* tilemap blocks of 8x8 tiles, one 64-bit mask each */
+#define MAP_BLOCK_SHIFT (3)
+
+#define RCL_COLUMN_FUNCTION R_DrawColumn
+#define RCL_COLUMN_TABLE_SIZE MAX_RENDER_WIDTH
+#ifdef NEUROTTIC_RCL_INLINE
+#define RCL_ARRAY_FUNCTION R_WallHeight
+#define RCL_TYPE_FUNCTION R_WallType
+#define RCL_EMPTY_BLOCK_FUNCTION R_BlockEmpty
+#define RCL_EMPTY_BLOCK_SHIFT MAP_BLOCK_SHIFT
+#endif
+#ifdef NEUROTTIC_BENCHMARK
+#define RCL_COUNT_STEPS
+#endif
+#ifdef NEUROTTIC_TRIG_LUT
+#define RCL_USE_COS_LUT 3
+#define RCL_COS_LUT_TABLE trig_rcl_cos
+#endif
+#include "thirdp/raycastlib.h"
+
+/* fixed.h converts game units to raycastlib units with a shift */
+SDL_COMPILE_TIME_ASSERT(rcl_units, RCL_UNITS_PER_SQUARE == FRACUNIT >> FIXED_RCL_SHIFT);
+
 /*
  * software renderer implementation
  */
 
+#define MAP_SIZE (128)
+#define NUM_MAP_BLOCKS (MAP_SIZE >> MAP_BLOCK_SHIFT)
+#define WALL_TEXTURE_SIZE (64)
+#define MAX_WALL_TEXTURES (256)
+
+#define MAX_SPRITE_PICS (256)
+#define SPRITE_TRANSPARENT (0xFF)
+
+/* sprites closer than this are not drawn */
+#define SPRITE_NEAR (RCL_UNITS_PER_SQUARE / 8)
+
+/* columns per block of the coarse depth buffer used to reject sprites */
+#define DEPTH_BLOCK (16)
+#define NUM_DEPTH_BLOCKS ((MAX_RENDER_WIDTH + DEPTH_BLOCK - 1) / DEPTH_BLOCK)
+
+/* dynamic resolution draws 2/8 to 8/8 of the view's columns */
+#define DYNRES_STEPS (8)
+#define DYNRES_MIN_STEP (2)
+
+/* frames over the budget before dropping columns, and well under it before adding them back */
+#define DYNRES_DROP_FRAMES (3)
+#define DYNRES_RAISE_FRAMES (RENDER_HZ)
+
+/* columns are only added back if the next step is predicted to stay under this fraction of the budget */
+#define DYNRES_HEADROOM (0.75f)
+
+/* shade tables fade from the palette (level 0) to black (the last level) */
+#define SHADE_LEVELS (32)
+
+/* blend tables mix two colors in 1/r_blend_levels steps of alpha */
+#define MAX_BLEND_LEVELS (16)
+#define BLEND_TABLE_SIZE (256 * 256)
+#define BLEND_CACHE_MAGIC "BLND"
+#define BLEND_CACHE_VERSION (1)
+
+/* palette blends are rounded to 1/PALETTE_BLEND_STEPS */
+#define PALETTE_BLEND_STEPS (64)
+
+/* ends each row of a surface's opaque runs */
+#define SURFACE_RUNS_END (0xFFFF)
+
+/* surface property holding its opaque runs */
+#define SURFACE_RUNS_PROPERTY "neurottic.surface_runs"
+
+/* largest floor or ceiling flat, in texels per side */
+#define MAX_FLAT_SIZE (256)
+
+/* flats may carry an lpic header of four shorts before the texels */
+#define FLAT_HEADER_SIZE (8)
+
+/* floor or ceiling lump, square and column-major like wall textures */
+typedef struct flat {
+	int shift; /* log2 of the texels per side */
+	Uint8 *pixels; /* NULL to draw the plane's flat color */
+} flat_t;
+
+/* opaque spans of a color keyed 8-bit surface, so scaled draws skip transparent texels without looking at them */
+typedef struct surface_runs {
+	Uint32 key; /* color key the runs were built for */
+	int w, h, pitch; /* size and pixels the runs were built for */
+	void *pixels;
+	Uint32 *rows; /* index of each row's first run */
+	Uint16 *runs; /* first and last + 1 column of each run, each row ends with SURFACE_RUNS_END */
+} surface_runs_t;
+
+/* sprite lump, converted from a patch to column-major pixels */
+typedef struct sprite_pic {
+	char name[9];
+	int origsize;
+	int width;
+	int height;
+	int leftoffset;
+	int topoffset;
+	Uint8 *pixels; /* NULL if the lump couldn't be loaded */
+} sprite_pic_t;
+
+/* sprite placed in the map */
+typedef struct sprite {
+	RCL_Vector2D position;
+	sprite_pic_t *pic;
+} sprite_t;
+
+/* sprite projected to the screen this frame */
+typedef struct vissprite {
+	RCL_Unit depth;
+	int x1, x2; /* unclipped screen columns, x2 exclusive */
+	int top; /* screen row of the top of the pic */
+	fixed_t scale; /* screen rows per texel */
+	fixed_t xscale; /* screen columns per texel, fewer than rows while dynamic resolution drops columns */
+	sprite_pic_t *pic;
+} vissprite_t;
+
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
 static SDL_Surface *surface8 = NULL;
@@ -37,100 +153,1285 @@ static SDL_Surface *surface24 = NULL;
 static SDL_Texture *texture = NULL;
 SDL_Surface *font = NULL;
 
-/* initialize renderer */
-int R_Init(void)
+/* 3D view, the screen itself when r_scale is 1 */
+static SDL_Surface *view8 = NULL;
+static int view_scale = 1;
+
+/* height of surface8, for the console on the logging thread */
+static SDL_AtomicInt screen_height = {0};
+
+/* cvars */
+static cvar_t *r_width = NULL;
+static cvar_t *r_height = NULL;
+static cvar_t *r_scale = NULL;
+static cvar_t *r_dynres = NULL;
+static cvar_t *r_dynres_budget = NULL;
+static cvar_t *r_fog = NULL;
+static cvar_t *r_fog_distance = NULL;
+static cvar_t *r_light = NULL;
+static cvar_t *r_blend_levels = NULL;
+
+/* dynamic resolution draws dynres_step / DYNRES_STEPS of the view's columns */
+static int dynres_step = DYNRES_STEPS;
+static int dynres_frames = 0; /* consecutive frames over the budget if positive, well under it if negative */
+
+/* raycaster state */
+static RCL_Camera camera;
+static RCL_RayConstraints constraints;
+static SDL_bool map_loaded = SDL_FALSE;
+static Uint8 floor_color = 0;
+static Uint8 ceiling_color = 0;
+
+/* wall tiles of the current map, flipped to raycastlib's y-up orientation */
+static Uint8 tilemap[MAP_SIZE][MAP_SIZE];
+
+/* one bit per wall tile of each block, rays cross empty blocks in one step */
+static Uint64 block_masks[NUM_MAP_BLOCKS][NUM_MAP_BLOCKS];
+static SDL_bool skip_blocks = SDL_TRUE;
+static cvar_t *r_skip_blocks = NULL;
+
+/* palette remapped for each shade level, rebuilt with the palette */
+static Uint8 shade_tables[SHADE_LEVELS][256];
+
+/* current palette, for building blend tables */
+static Uint8 palette_rgb[768];
+
+/* screen color of each palette index, in the format of surface24 and with the palette blend applied */
+static Uint32 output_lut[256];
+
+/* color the palette is blended toward, and how far in PALETTE_BLEND_STEPS */
+static SDL_Color palette_blend = {0, 0, 0, 255};
+static int palette_blend_step = 0;
+
+/* blend_levels - 1 tables indexed by [src << 8 | dst], the first one is the least opaque. built on first use */
+static Uint8 *blend_tables = NULL;
+static int blend_levels = 0;
+
+/* shade level of everything this frame, and the levels added per unit of depth in 16.16 */
+static int shade_light = 0;
+static Sint64 shade_fog_scale = 0;
+
+/* wall textures by tile index, 64x64 column-major */
+static Uint8 *wall_textures[MAX_WALL_TEXTURES];
+
+/* floor and ceiling of the current map */
+static flat_t floor_flat;
+static flat_t ceiling_flat;
+
+/* ceiling rows are above ceiling_clip, floor rows start at floor_clip, set by R_DrawColumn() */
+static Sint16 ceiling_clip[MAX_RENDER_WIDTH];
+static Sint16 floor_clip[MAX_RENDER_WIDTH];
+
+/* distance of each row to the floor or ceiling, for the eye height and resolution it was built for */
+static RCL_Unit plane_distances[MAX_RENDER_HEIGHT];
+static RCL_Unit plane_distances_height = -1;
+static RCL_Unit plane_distances_rows = 0;
+
+/* sprites */
+static sprite_pic_t sprite_pics[MAX_SPRITE_PICS];
+static int num_sprite_pics = 0;
+static sprite_t *sprites = NULL;
+static vissprite_t *vissprites = NULL;
+static int num_sprites = 0;
+
+/* wall depth of each column, and the farthest one in each block of columns */
+static RCL_Unit column_depth[MAX_RENDER_WIDTH];
+static RCL_Unit block_depth[NUM_DEPTH_BLOCKS];
+
+/* statistics of the last R_CastRays() */
+static ray_stats_t ray_stats;
+static Uint32 column_start_steps = 0;
+
+/* pixels of the view already drawn by a nearer sprite are marked with the frame's stamp */
+static Uint16 *coverage = NULL;
+static Uint16 coverage_stamp = 0;
+static int coverage_columns = 0; /* row pitch of coverage, the view's column count when it was last cleared */
+
+/*
+ * raycaster callbacks
+ */
+
+static inline RCL_Unit R_WallHeight(int16_t x, int16_t y)
+{
+	if (x < 0 || y < 0 || x >= MAP_SIZE || y >= MAP_SIZE)
+		return RCL_UNITS_PER_SQUARE;
+
+	return tilemap[y][x] ? RCL_UNITS_PER_SQUARE : 0;
+}
+
+static inline RCL_Unit R_WallType(int16_t x, int16_t y)
+{
+	if (x < 0 || y < 0 || x >= MAP_SIZE || y >= MAP_SIZE)
+		return 0;
+
+	return tilemap[y][x];
+}
+
+static inline int8_t R_BlockEmpty(int16_t x, int16_t y)
+{
+	if (x < 0 || y < 0 || x >= NUM_MAP_BLOCKS || y >= NUM_MAP_BLOCKS)
+		return 0;
+
+	return skip_blocks && block_masks[y][x] == 0;
+}
+
+/* shade table for something at depth away from the camera */
+static inline const Uint8 *R_ShadeTable(RCL_Unit depth)
+{
+	Sint64 level = shade_light + ((depth * shade_fog_scale) >> 16);
+
+	return shade_tables[SDL_min(level, SHADE_LEVELS - 1)];
+}
+
+/* draw the wall slice of one column, floors and ceilings are drawn by R_DrawPlanes() */
+void R_DrawColumn(RCL_ColumnInfo *column)
+{
+	Uint8 *dst;
+	Uint8 *texture;
+	const Uint8 *shade;
+	int x = column->x;
+	int count = column->bottom - column->top + 1;
+
+	ceiling_clip[x] = column->top;
+	floor_clip[x] = column->bottom + 1;
+
+	if (count <= 0)
+		return;
+
+	column_depth[x] = column->depth;
+
+	dst = (Uint8 *)view8->pixels + column->top * view8->pitch + x;
+	texture = wall_textures[column->hit->type];
+	shade = R_ShadeTable(column->depth);
+
+	if (texture)
+	{
+		int u = (column->texCoordX * WALL_TEXTURE_SIZE / RCL_UNITS_PER_SQUARE) & (WALL_TEXTURE_SIZE - 1);
+		const Uint8 *src = texture + u * WALL_TEXTURE_SIZE;
+
+		/* 16.16 texels */
+		Uint32 v = (Uint32)(((Sint64)column->texCoordY * (WALL_TEXTURE_SIZE << 16)) / (RCL_UNITS_PER_SQUARE * RCL_TEXTURE_INTERPOLATION_SCALE));
+		Uint32 step = (Uint32)(((Sint64)column->texStepY * (WALL_TEXTURE_SIZE << 16)) / (RCL_UNITS_PER_SQUARE * RCL_TEXTURE_INTERPOLATION_SCALE));
+
+		while (count--)
+		{
+			*dst = shade[src[(v >> 16) & (WALL_TEXTURE_SIZE - 1)]];
+			dst += view8->pitch;
+			v += step;
+		}
+	}
+	else
+	{
+		Uint8 color = shade[(Uint8)column->hit->type];
+
+		while (count--)
+		{
+			*dst = color;
+			dst += view8->pitch;
+		}
+	}
+}
+
+/*
+ * floors and ceilings
+ */
+
+/* load floor or ceiling lump, replacing the previous one */
+static void R_LoadFlat(flat_t *flat, const char *name)
+{
+	Uint8 *data;
+	size_t size;
+
+	if (flat->pixels)
+		SDL_free(flat->pixels);
+
+	flat->pixels = NULL;
+
+	if (!name)
+		return;
+
+	data = LM_LoadLump(name, &size);
+	if (!data)
+		return;
+
+	for (int shift = 4; (1 << shift) <= MAX_FLAT_SIZE; shift++)
+	{
+		size_t texels = (size_t)1 << (shift * 2);
+
+		if (size == texels || size == texels + FLAT_HEADER_SIZE)
+		{
+			/* drop the header, if any */
+			SDL_memmove(data, data + (size - texels), texels);
+			flat->shift = shift;
+			flat->pixels = data;
+			return;
+		}
+	}
+
+	LogWarning("R_LoadFlat(): Flat \"%s\" has an unexpected size (%zu bytes)", name, size);
+	SDL_free(data);
+}
+
+/* draw one row of a textured plane, u and v are 16.16 texel coordinates */
+static void R_DrawSpan(Uint8 *dst, int count, Uint32 u, Uint32 v, Uint32 du, Uint32 dv, const flat_t *flat, const Uint8 *shade)
+{
+	const Uint8 *pixels = flat->pixels;
+	int shift = flat->shift;
+	Uint32 mask = (1 << shift) - 1;
+
+	while (count--)
+	{
+		*dst++ = shade[pixels[(((u >> 16) & mask) << shift) | ((v >> 16) & mask)]];
+		u += du;
+		v += dv;
+	}
+}
+
+/* rebuild the row distances if the eye height or resolution changed */
+static void R_UpdatePlaneDistances(void)
+{
+	int middle_row = camera.resolution.y / 2;
+	RCL_Unit floor_height, ceiling_height;
+
+	if (camera.height == plane_distances_height && camera.resolution.y == plane_distances_rows)
+		return;
+
+	/* distance of the eye to each plane, in screen rows */
+	floor_height = camera.height * camera.resolution.y / RCL_UNITS_PER_SQUARE;
+	ceiling_height = (RCL_UNITS_PER_SQUARE - camera.height) * camera.resolution.y / RCL_UNITS_PER_SQUARE;
+
+	for (int y = 0; y < camera.resolution.y; y++)
+		plane_distances[y] = RCL_perspectiveScaleVerticalInverse(y >= middle_row ? floor_height : ceiling_height, RCL_abs(y - middle_row));
+
+	plane_distances_height = camera.height;
+	plane_distances_rows = camera.resolution.y;
+}
+
+/* ray direction of a column, as RCL_castRaysMultiHit() casts it */
+static RCL_Vector2D R_ColumnDirection(int x)
+{
+	RCL_Vector2D d = _RCL_columnDirections[x];
+	RCL_Unit sin = RCL_sin(camera.direction);
+	RCL_Unit cos = RCL_cos(camera.direction);
+	RCL_Vector2D r;
+
+	r.x = (d.x * cos + d.y * sin) / RCL_UNITS_PER_SQUARE;
+	r.y = (d.y * cos - d.x * sin) / RCL_UNITS_PER_SQUARE;
+
+	return r;
+}
+
+/* walk each row once, every pixel of a row is at the same distance */
+static void R_DrawPlanes(void)
+{
+	PROFILE_FUNCTION();
+
+	int middle_row = camera.resolution.y / 2;
+	int last_column = SDL_max(camera.resolution.x - 1, 1);
+	RCL_Vector2D dir1, dir2;
+	Sint64 dx, dy, ux, uy;
+
+	R_UpdatePlaneDistances();
+
+	/* the rays of the first and last column, rotated from the same table the
+	 * walls were cast with, one unit deep */
+	dir1 = R_ColumnDirection(0);
+	dir2 = R_ColumnDirection(last_column);
+
+	dx = dir2.x - dir1.x;
+	dy = dir2.y - dir1.y;
+	ux = (Sint64)camera.position.x * RCL_UNITS_PER_SQUARE;
+	uy = (Sint64)camera.position.y * RCL_UNITS_PER_SQUARE;
+
+	for (int y = 0; y < camera.resolution.y; y++)
+	{
+		SDL_bool is_floor = y >= middle_row;
+		const flat_t *flat = is_floor ? &floor_flat : &ceiling_flat;
+		RCL_Unit distance = plane_distances[y];
+		const Uint8 *shade = R_ShadeTable(distance);
+		Uint8 color = shade[is_floor ? floor_color : ceiling_color];
+		Uint8 *row = (Uint8 *)view8->pixels + y * view8->pitch;
+		Uint32 u = 0, v = 0, du = 0, dv = 0;
+		int x = 0;
+
+		/* left edge of the row and the step per column, in 16.16 texels */
+		if (flat->pixels && distance != RCL_INFINITY)
+		{
+			Sint64 scale = (Sint64)1 << (flat->shift + 16);
+			Sint64 denom = (Sint64)RCL_UNITS_PER_SQUARE * RCL_UNITS_PER_SQUARE;
+
+			u = (Uint32)((ux + (Sint64)dir1.x * distance) * scale / denom);
+			v = (Uint32)((uy + (Sint64)dir1.y * distance) * scale / denom);
+			du = (Uint32)(dx * distance * scale / (denom * last_column));
+			dv = (Uint32)(dy * distance * scale / (denom * last_column));
+		}
+		else
+		{
+			flat = NULL;
+		}
+
+		while (x < camera.resolution.x)
+		{
+			int x1;
+
+			/* skip columns covered by walls */
+			if (is_floor)
+				while (x < camera.resolution.x && y < floor_clip[x]) x++;
+			else
+				while (x < camera.resolution.x && y >= ceiling_clip[x]) x++;
+
+			x1 = x;
+
+			if (is_floor)
+				while (x < camera.resolution.x && y >= floor_clip[x]) x++;
+			else
+				while (x < camera.resolution.x && y < ceiling_clip[x]) x++;
+
+			if (x == x1)
+				continue;
+
+			if (flat)
+				R_DrawSpan(row + x1, x - x1, u + du * x1, v + dv * x1, du, dv, flat, shade);
+			else
+				SDL_memset(row + x1, color, x - x1);
+		}
+	}
+}
+
+/*
+ * sprites
+ */
+
+/* load patch lump into a sprite pic, with transparent pixels keyed */
+static int R_LoadSpritePic(sprite_pic_t *pic, const char *name)
+{
+	Uint8 *data;
+	size_t size;
+	SDL_IOStream *io;
+	Sint16 origsize, width, height, leftoffset, topoffset;
+
+	data = LM_LoadLump(name, &size);
+	if (!data)
+		return -1;
+
+	io = SDL_IOFromConstMem(data, size);
+	if (!io)
+	{
+		SDL_free(data);
+		return -1;
+	}
+
+	if (!SDL_ReadS16LE(io, &origsize) || !SDL_ReadS16LE(io, &width) ||
+		!SDL_ReadS16LE(io, &height) || !SDL_ReadS16LE(io, &leftoffset) ||
+		!SDL_ReadS16LE(io, &topoffset) || width <= 0 || height <= 0 ||
+		10 + (size_t)width * 2 > size)
+	{
+		SDL_CloseIO(io);
+		SDL_free(data);
+		return LogError("R_LoadSpritePic(): \"%s\" is not a valid patch", name);
+	}
+
+	pic->pixels = SDL_malloc(width * height);
+	if (!pic->pixels)
+	{
+		SDL_CloseIO(io);
+		SDL_free(data);
+		return LogError("R_LoadSpritePic(): Memory allocation of %d bytes failed", width * height);
+	}
+
+	SDL_memset(pic->pixels, SPRITE_TRANSPARENT, width * height);
+
+	/* each column is a list of posts: Uint8 top, Uint8 length, Uint8 pixels[length], ending with 0xFF */
+	for (int x = 0; x < width; x++)
+	{
+		Uint16 ofs;
+		Uint8 *column = pic->pixels + x * height;
+
+		SDL_ReadU16LE(io, &ofs);
+
+		while (ofs < size && data[ofs] != 0xFF)
+		{
+			int top = data[ofs];
+			int length = ofs + 1 < size ? data[ofs + 1] : 0;
+
+			if (ofs + 2 + (size_t)length > size)
+				break;
+
+			for (int y = 0; y < length && top + y < height; y++)
+				column[top + y] = data[ofs + 2 + y];
+
+			ofs += 2 + length;
+		}
+	}
+
+	SDL_CloseIO(io);
+	SDL_free(data);
+
+	pic->origsize = origsize > 0 ? origsize : width;
+	pic->width = width;
+	pic->height = height;
+	pic->leftoffset = leftoffset;
+	pic->topoffset = topoffset;
+
+	return 0;
+}
+
+/* find sprite pic, loading it on first use. failed loads are remembered too */
+static sprite_pic_t *R_CacheSpritePic(const char *name)
+{
+	sprite_pic_t *pic;
+
+	for (int i = 0; i < num_sprite_pics; i++)
+	{
+		if (SDL_strncasecmp(sprite_pics[i].name, name, 8) == 0)
+			return sprite_pics[i].pixels ? &sprite_pics[i] : NULL;
+	}
+
+	if (num_sprite_pics >= MAX_SPRITE_PICS)
+	{
+		LogWarning("R_CacheSpritePic(): Too many sprite pics");
+		return NULL;
+	}
+
+	pic = &sprite_pics[num_sprite_pics++];
+	SDL_memset(pic, 0, sizeof(sprite_pic_t));
+	SDL_strlcpy(pic->name, name, sizeof(pic->name));
+
+	if (R_LoadSpritePic(pic, name) != 0)
+		return NULL;
+
+	return pic;
+}
+
+static void R_FreeSprites(void)
+{
+	if (sprites)
+		SDL_free(sprites);
+	if (vissprites)
+		SDL_free(vissprites);
+
+	sprites = NULL;
+	vissprites = NULL;
+	num_sprites = 0;
+}
+
+/* spawn sprites for the objects in the current map's sprite plane */
+static int R_SpawnSprites(void)
+{
+	Uint16 *objects = MS_GetCurrentMapPlane(1);
+	int count = 0;
+
+	R_FreeSprites();
+
+	if (!objects)
+		return 0;
+
+	for (int i = 0; i < MAP_SIZE * MAP_SIZE; i++)
+	{
+		if (DarkWar_GetSprite(objects[i]))
+			count++;
+	}
+
+	if (!count)
+		return 0;
+
+	sprites = SDL_calloc(count, sizeof(sprite_t));
+	vissprites = SDL_calloc(count, sizeof(vissprite_t));
+	if (!sprites || !vissprites)
+	{
+		R_FreeSprites();
+		return LogError("R_SpawnSprites(): Memory allocation of %zu bytes failed", count * (sizeof(sprite_t) + sizeof(vissprite_t)));
+	}
+
+	for (int i = 0; i < MAP_SIZE * MAP_SIZE; i++)
+	{
+		const char *name = DarkWar_GetSprite(objects[i]);
+		sprite_pic_t *pic;
+
+		if (!name || !(pic = R_CacheSpritePic(name)))
+			continue;
+
+		/* centered in the tile, in raycastlib's y-up orientation */
+		sprites[num_sprites].position.x = (i % MAP_SIZE) * RCL_UNITS_PER_SQUARE + RCL_UNITS_PER_SQUARE / 2;
+		sprites[num_sprites].position.y = (MAP_SIZE - 1 - i / MAP_SIZE) * RCL_UNITS_PER_SQUARE + RCL_UNITS_PER_SQUARE / 2;
+		sprites[num_sprites].pic = pic;
+		num_sprites++;
+	}
+
+	return Log("Spawned %d sprites", num_sprites);
+}
+
+static int R_CompareVisSprites(const void *a, const void *b)
+{
+	const vissprite_t *va = (const vissprite_t *)a;
+	const vissprite_t *vb = (const vissprite_t *)b;
+
+	return (va->depth > vb->depth) - (va->depth < vb->depth);
+}
+
+/* returns SDL_TRUE if walls are in front of every column from x1 to x2 */
+static SDL_bool R_SpriteOccluded(int x1, int x2, RCL_Unit depth)
+{
+	for (int b = x1 / DEPTH_BLOCK; b <= (x2 - 1) / DEPTH_BLOCK; b++)
+	{
+		if (block_depth[b] > depth)
+			return SDL_FALSE;
+	}
+
+	return SDL_TRUE;
+}
+
+/* draw one sprite, skipping columns behind walls and pixels covered by nearer sprites */
+static void R_DrawVisSprite(vissprite_t *vis)
+{
+	sprite_pic_t *pic = vis->pic;
+	const Uint8 *shade = R_ShadeTable(vis->depth);
+	fixed_t step = (fixed_t)(((Sint64)FRACUNIT << FRACBITS) / vis->scale);
+	fixed_t xstep = (fixed_t)(((Sint64)FRACUNIT << FRACBITS) / vis->xscale);
+	int bottom = vis->top + (int)(((Sint64)pic->height * vis->scale) >> FRACBITS);
+	int x1 = SDL_max(vis->x1, 0);
+	int x2 = SDL_min(vis->x2, camera.resolution.x);
+	int y1 = SDL_max(vis->top, 0);
+	int y2 = SDL_min(bottom, camera.resolution.y);
+	fixed_t vstart = (y1 - vis->top) * step;
+
+	for (int x = x1; x < x2; x++)
+	{
+		int u = (int)(((Sint64)(x - vis->x1) * xstep) >> FRACBITS);
+		Uint8 *column, *dst;
+		Uint16 *cov;
+		fixed_t v = vstart;
+
+		if (column_depth[x] <= vis->depth || u >= pic->width)
+			continue;
+
+		column = pic->pixels + u * pic->height;
+		dst = (Uint8 *)view8->pixels + y1 * view8->pitch + x;
+		cov = coverage + y1 * camera.resolution.x + x;
+
+		for (int y = y1; y < y2; y++)
+		{
+			Uint8 texel = column[SDL_min(v >> FRACBITS, pic->height - 1)];
+
+			if (texel != SPRITE_TRANSPARENT && *cov != coverage_stamp)
+			{
+				*dst = shade[texel];
+				*cov = coverage_stamp;
+			}
+
+			dst += view8->pitch;
+			cov += camera.resolution.x;
+			v += step;
+		}
+	}
+}
+
+static void R_DrawSprites(void)
+{
+	PROFILE_FUNCTION();
+
+	RCL_Unit cs = RCL_cos(camera.direction);
+	RCL_Unit sn = RCL_sin(camera.direction);
+	int middle_column = camera.resolution.x / 2;
+	int middle_row = camera.resolution.y / 2;
+	int num_depth_blocks = (camera.resolution.x + DEPTH_BLOCK - 1) / DEPTH_BLOCK;
+	int num_vissprites = 0;
+
+	if (!num_sprites)
+		return;
+
+	/* farthest wall in each block of columns */
+	for (int b = 0; b < num_depth_blocks; b++)
+	{
+		block_depth[b] = 0;
+
+		for (int x = b * DEPTH_BLOCK; x < SDL_min((b + 1) * DEPTH_BLOCK, camera.resolution.x); x++)
+			block_depth[b] = SDL_max(block_depth[b], column_depth[x]);
+	}
+
+	/* project, the same way as RCL_mapToScreen() */
+	for (int i = 0; i < num_sprites; i++)
+	{
+		sprite_t *sprite = &sprites[i];
+		vissprite_t *vis = &vissprites[num_vissprites];
+		RCL_Unit dx = sprite->position.x - camera.position.x;
+		RCL_Unit dy = sprite->position.y - camera.position.y;
+		RCL_Unit depth = (dx * cs - dy * sn) / RCL_UNITS_PER_SQUARE;
+		RCL_Unit side = (dx * sn + dy * cs) / RCL_UNITS_PER_SQUARE;
+		int center, top, bottom;
+
+		if (depth < SPRITE_NEAR)
+			continue;
+
+		center = middle_column - RCL_perspectiveScaleHorizontal(side, depth) * middle_column / RCL_UNITS_PER_SQUARE;
+		top = middle_row - RCL_perspectiveScaleVertical(RCL_UNITS_PER_SQUARE - camera.height, depth) * camera.resolution.y / RCL_UNITS_PER_SQUARE;
+		bottom = middle_row - RCL_perspectiveScaleVertical(-camera.height, depth) * camera.resolution.y / RCL_UNITS_PER_SQUARE;
+
+		if (bottom <= top)
+			continue;
+
+		/* the pic's origsize spans the whole tile height */
+		vis->depth = depth;
+		vis->pic = sprite->pic;
+		vis->scale = (fixed_t)(((Sint64)(bottom - top) << FRACBITS) / vis->pic->origsize);
+		vis->xscale = (fixed_t)(((Sint64)vis->scale * camera.resolution.x) / view8->w);
+		vis->x1 = center + (int)(((Sint64)(vis->pic->leftoffset - vis->pic->origsize / 2) * vis->xscale) >> FRACBITS);
+		vis->x2 = vis->x1 + (int)(((Sint64)vis->pic->width * vis->xscale) >> FRACBITS);
+		vis->top = top + (int)(((Sint64)vis->pic->topoffset * vis->scale) >> FRACBITS);
+
+		if (vis->x2 <= 0 || vis->x1 >= camera.resolution.x || vis->x2 <= vis->x1 || vis->scale <= 0 || vis->xscale <= 0)
+			continue;
+
+		if (R_SpriteOccluded(SDL_max(vis->x1, 0), SDL_min(vis->x2, camera.resolution.x), depth))
+			continue;
+
+		num_vissprites++;
+	}
+
+	/* front to back, so covered pixels are never drawn twice */
+	SDL_qsort(vissprites, num_vissprites, sizeof(vissprite_t), R_CompareVisSprites);
+
+	/* dynamic resolution changed the row pitch, old stamps could land anywhere */
+	if (camera.resolution.x != coverage_columns)
+	{
+		SDL_memset(coverage, 0, view8->w * view8->h * sizeof(Uint16));
+		coverage_stamp = 0;
+		coverage_columns = camera.resolution.x;
+	}
+
+	/* clear all of it, rows of earlier frames may have had another width */
+	if (++coverage_stamp == 0)
+	{
+		SDL_memset(coverage, 0, view8->w * view8->h * sizeof(Uint16));
+		coverage_stamp = 1;
+	}
+
+	for (int i = 0; i < num_vissprites; i++)
+		R_DrawVisSprite(&vissprites[i]);
+}
+
+/*
+ * screen and view surfaces
+ */
+
+/* rebuild the 256 screen colors, the only work a palette blend costs */
+static void R_UpdateOutputLUT(void)
+{
+	if (!surface24)
+		return;
+
+	for (int i = 0; i < 256; i++)
+	{
+		const Uint8 *c = palette_rgb + i * 3;
+
+		output_lut[i] = SDL_MapRGB(surface24->format,
+			c[0] + (palette_blend.r - c[0]) * palette_blend_step / PALETTE_BLEND_STEPS,
+			c[1] + (palette_blend.g - c[1]) * palette_blend_step / PALETTE_BLEND_STEPS,
+			c[2] + (palette_blend.b - c[2]) * palette_blend_step / PALETTE_BLEND_STEPS);
+	}
+}
+
+static int CMD_PaletteBlend(int argc, char **argv)
+{
+	if (argc != 5)
+	{
+		Console_Printf("Usage: palette_blend <r> <g> <b> <amount>");
+		return 0;
+	}
+
+	R_SetPaletteBlend(SDL_atoi(argv[1]), SDL_atoi(argv[2]), SDL_atoi(argv[3]), (float)SDL_atof(argv[4]));
+
+	return 0;
+}
+
+static void R_DestroySurfaces(void)
+{
+	if (view8 && view8 != surface8) SDL_DestroySurface(view8);
+	if (surface8) SDL_DestroySurface(surface8);
+	if (surface24) SDL_DestroySurface(surface24);
+	if (texture) SDL_DestroyTexture(texture);
+	if (coverage) SDL_free(coverage);
+
+	view8 = NULL;
+	surface8 = NULL;
+	surface24 = NULL;
+	texture = NULL;
+	coverage = NULL;
+
+	SDL_AtomicSet(&screen_height, 0);
+}
+
+/* create the screen surfaces at width x height, and the 3D view at 1/scale of that. the old ones are kept on failure */
+static int R_SetMode(int width, int height, int scale)
+{
+	SDL_Surface *new_surface8 = NULL, *new_surface24 = NULL, *new_view8 = NULL;
+	SDL_Texture *new_texture = NULL;
+	Uint16 *new_coverage = NULL;
+	Uint32 format;
+	int view_width, view_height;
+
+	width = SDL_clamp(width, MIN_RENDER_WIDTH, MAX_RENDER_WIDTH);
+	height = SDL_clamp(height, MIN_RENDER_HEIGHT, MAX_RENDER_HEIGHT);
+	scale = SDL_clamp(scale, 1, MAX_RENDER_SCALE);
+
+	if (surface8 && surface8->w == width && surface8->h == height && scale == view_scale)
+		return 0;
+
+	view_width = width / scale;
+	view_height = height / scale;
+
+	format = SDL_GetWindowPixelFormat(window);
+
+	new_surface8 = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_INDEX8);
+	new_surface24 = SDL_CreateSurface(width, height, format);
+	new_texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+	new_view8 = scale > 1 ? SDL_CreateSurface(view_width, view_height, SDL_PIXELFORMAT_INDEX8) : new_surface8;
+	new_coverage = SDL_calloc(view_width * view_height, sizeof(Uint16));
+
+	if (!new_surface8 || !new_surface24 || !new_texture || !new_view8 || !new_coverage)
+	{
+		if (new_view8 && new_view8 != new_surface8) SDL_DestroySurface(new_view8);
+		if (new_surface8) SDL_DestroySurface(new_surface8);
+		if (new_surface24) SDL_DestroySurface(new_surface24);
+		if (new_texture) SDL_DestroyTexture(new_texture);
+		if (new_coverage) SDL_free(new_coverage);
+		return LogError("R_SetMode(): Failed to create %dx%d surfaces: %s", width, height, SDL_GetError());
+	}
+
+	SDL_FillSurfaceRect(new_surface8, NULL, 0);
+	SDL_SetTextureScaleMode(new_texture, SDL_SCALEMODE_NEAREST);
+
+	/* keep the current palette */
+	if (surface8)
+		SDL_SetPaletteColors(new_surface8->format->palette, surface8->format->palette->colors, 0, 256);
+
+	R_DestroySurfaces();
+
+	surface8 = new_surface8;
+	surface24 = new_surface24;
+	texture = new_texture;
+	view8 = new_view8;
+	view_scale = scale;
+	coverage = new_coverage;
+	coverage_stamp = 0;
+	coverage_columns = view_width;
+
+	SDL_AtomicSet(&screen_height, height);
+
+	camera.resolution.x = view_width;
+	camera.resolution.y = view_height;
+
+	R_UpdateOutputLUT();
+
+	dynres_step = DYNRES_STEPS;
+	dynres_frames = 0;
+
+	SDL_SetRenderLogicalPresentation(renderer, width, height, SDL_LOGICAL_PRESENTATION_LETTERBOX, SDL_SCALEMODE_NEAREST);
+
+	return Log("Screen resolution %dx%d, 3D view %dx%d", width, height, view_width, view_height);
+}
+
+static void CVAR_Mode(cvar_t *cvar)
+{
+	/* the surfaces are created by R_Init_REAL() once all of the cvars exist */
+	if (surface8)
+		R_SetMode(r_width->value_int, r_height->value_int, r_scale->value_int);
+}
+
+/* scale the drawn columns of the 3D view up to the screen, each view row is widened once and then copied down */
+static void R_UpscaleView(void)
+{
+	PROFILE_FUNCTION();
+
+	int row_size = view8->w * view_scale;
+	int rows = view_scale;
+	int columns = camera.resolution.x;
+	Uint32 step = ((Uint32)columns << 16) / row_size;
+
+	for (int y = 0; y < view8->h; y++)
+	{
+		const Uint8 *src = (const Uint8 *)view8->pixels + y * view8->pitch;
+		Uint8 *dst = (Uint8 *)surface8->pixels + y * view_scale * surface8->pitch;
+
+		if (columns * view_scale != row_size)
+		{
+			/* right to left, so the view can be widened in place when it is the screen */
+			for (int x = row_size - 1; x >= 0; x--)
+				dst[x] = src[(x * step) >> 16];
+		}
+		else
+		{
+			switch (view_scale)
+			{
+				case 2:
+					for (int x = 0; x < view8->w; x++)
+						((Uint16 *)dst)[x] = src[x] * 0x0101;
+					break;
+
+				case 4:
+					for (int x = 0; x < view8->w; x++)
+						((Uint32 *)dst)[x] = src[x] * 0x01010101u;
+					break;
+
+				default:
+					for (int x = 0; x < view8->w; x++)
+						SDL_memset(dst + x * view_scale, src[x], view_scale);
+					break;
+			}
+		}
+
+		/* stretch the last column and row over what's left when the scale doesn't divide the screen */
+		if (row_size < surface8->w)
+			SDL_memset(dst + row_size, dst[row_size - 1], surface8->w - row_size);
+
+		if (y == view8->h - 1)
+			rows = surface8->h - y * view_scale;
+
+		for (int i = 1; i < rows; i++)
+			SDL_memcpy(dst + i * surface8->pitch, dst, surface8->w);
+	}
+}
+
+/* drop columns after a few frames over the budget, add them back after a second well under it */
+static void R_UpdateDynamicResolution(float ms)
+{
+	float budget = r_dynres_budget->value_float;
+
+	if (!r_dynres->value_int || budget <= 0)
+	{
+		dynres_step = DYNRES_STEPS;
+		dynres_frames = 0;
+		return;
+	}
+
+	if (ms > budget)
+	{
+		dynres_frames = SDL_max(dynres_frames, 0) + 1;
+
+		if (dynres_frames >= DYNRES_DROP_FRAMES && dynres_step > DYNRES_MIN_STEP)
+		{
+			dynres_step--;
+			dynres_frames = 0;
+		}
+	}
+	else if (dynres_step < DYNRES_STEPS && ms * (dynres_step + 1) / dynres_step < budget * DYNRES_HEADROOM)
+	{
+		dynres_frames = SDL_min(dynres_frames, 0) - 1;
+
+		if (-dynres_frames >= DYNRES_RAISE_FRAMES)
+		{
+			dynres_step++;
+			dynres_frames = 0;
+		}
+	}
+	else
+	{
+		dynres_frames = 0;
+	}
+}
+
+/* initialize renderer */
+int R_Init_REAL(void)
+{
+	window = SDL_CreateWindow("NEUROTTIC", RENDER_WIDTH, RENDER_HEIGHT, SDL_WINDOW_RESIZABLE);
+	if (!window)
+		return -1;
+
+	SDL_SetWindowMinimumSize(window, RENDER_WIDTH, RENDER_HEIGHT);
+
+	renderer = SDL_CreateRenderer(window, NULL);
+	if (!renderer)
+		return -1;
+
+	SDL_SetRenderVSync(renderer, 1);
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+	SDL_RenderPresent(renderer);
+
+	/* setup raycaster */
+	RCL_initCamera(&camera);
+
+	r_skip_blocks = Console_RegisterCvar("r_skip_blocks", "1", CVAR_BOOL, NULL);
+
+	/* screen resolution and 3D view divisor, changing them recreates the surfaces */
+	r_width = Console_RegisterCvar("r_width", "640", CVAR_INT, CVAR_Mode);
+	r_height = Console_RegisterCvar("r_height", "480", CVAR_INT, CVAR_Mode);
+	r_scale = Console_RegisterCvar("r_scale", "1", CVAR_INT, CVAR_Mode);
+
+	/* draw fewer columns while the 3D view takes longer than r_dynres_budget milliseconds */
+	r_dynres = Console_RegisterCvar("r_dynres", "0", CVAR_BOOL, NULL);
+	r_dynres_budget = Console_RegisterCvar("r_dynres_budget", "20", CVAR_FLOAT, NULL);
+
+	/* distance fog fades to black at r_fog_distance tiles, r_light darkens everything by shade levels */
+	r_fog = Console_RegisterCvar("r_fog", "0", CVAR_BOOL, NULL);
+	r_fog_distance = Console_RegisterCvar("r_fog_distance", "32", CVAR_FLOAT, NULL);
+	r_light = Console_RegisterCvar("r_light", "0", CVAR_INT, NULL);
+
+	/* translucency steps of R_DrawSurfaceBlended(), from 2 up to MAX_BLEND_LEVELS */
+	r_blend_levels = Console_RegisterCvar("r_blend_levels", "4", CVAR_INT, NULL);
+
+	Console_RegisterCommand("palette_blend", CMD_PaletteBlend);
+
+	if (!r_width || !r_height || !r_scale || !r_dynres || !r_dynres_budget ||
+		!r_fog || !r_fog_distance || !r_light || !r_blend_levels)
+		return -1;
+
+	if (R_SetMode(r_width->value_int, r_height->value_int, r_scale->value_int) != 0)
+		return -1;
+
+	RCL_initRayConstraints(&constraints);
+	constraints.maxHits = 1;
+	constraints.maxSteps = MAP_SIZE * 2;
+
+	/* create font atlas */
+	font = SDL_CreateSurface(256 * 8, 8, SDL_PIXELFORMAT_INDEX8);
+	if (!font)
+		return -1;
+
+	SDL_FillSurfaceRect(font, NULL, 0);
+	SDL_SetSurfaceColorKey(font, SDL_TRUE, 0);
+
+	for (int c = 0; c < 256; c++)
+	{
+		char *bitmap = font8x8[c];
+
+		for (int y = 0; y < 8; y++)
+		{
+			for (int x = 0; x < 8; x++)
+			{
+				if (bitmap[y] & 1 << x)
+				{
+					size_t ofs = y * font->pitch + x + (8 * c);
+					((Uint8 *)font->pixels)[ofs] = 255;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* shutdown renderer */
+void R_Quit_REAL(void)
+{
+	R_DestroySurfaces();
+
+	if (renderer) SDL_DestroyRenderer(renderer);
+	if (window) SDL_DestroyWindow(window);
+	if (font) SDL_DestroySurface(font);
+
+	for (int i = 0; i < MAX_WALL_TEXTURES; i++)
+	{
+		if (wall_textures[i])
+			SDL_free(wall_textures[i]);
+		wall_textures[i] = NULL;
+	}
+
+	for (int i = 0; i < num_sprite_pics; i++)
+	{
+		if (sprite_pics[i].pixels)
+			SDL_free(sprite_pics[i].pixels);
+	}
+
+	num_sprite_pics = 0;
+	R_FreeSprites();
+
+	R_LoadFlat(&floor_flat, NULL);
+	R_LoadFlat(&ceiling_flat, NULL);
+
+	if (blend_tables)
+		SDL_free(blend_tables);
+
+	blend_tables = NULL;
+	blend_levels = 0;
+
+	map_loaded = SDL_FALSE;
+	window = NULL;
+	renderer = NULL;
+	font = NULL;
+
+	/* the console frees these after us */
+	r_width = r_height = r_scale = NULL;
+	r_dynres = r_dynres_budget = NULL;
+	r_fog = r_fog_distance = r_light = NULL;
+	r_blend_levels = NULL;
+	r_skip_blocks = NULL;
+}
+
+/* clear screen */
+void R_Clear(Uint8 color)
+{
+	SDL_FillSurfaceRect(surface8, NULL, color);
+}
+
+/* draw scene */
+int R_Draw(void)
+{
+	PROFILE_FUNCTION();
+
+	Uint64 start;
+
+	if (!map_loaded)
+		return 0;
+
+	start = SDL_GetPerformanceCounter();
+
+	/* the columns dynamic resolution left for this frame */
+	camera.resolution.x = view8->w * dynres_step / DYNRES_STEPS;
+
+	/* columns without a wall hit are infinitely far away */
+	for (int x = 0; x < camera.resolution.x; x++)
+		column_depth[x] = RCL_INFINITY;
+
+	skip_blocks = !r_skip_blocks || r_skip_blocks->value_int;
+
+	/* fog darkens a level per SHADE_LEVELS-th of r_fog_distance tiles, on top of r_light */
+	shade_light = r_light ? SDL_clamp(r_light->value_int, 0, SHADE_LEVELS - 1) : 0;
+	shade_fog_scale = 0;
+
+	if (r_fog && r_fog->value_int && r_fog_distance->value_float > 0)
+		shade_fog_scale = (Sint64)((SHADE_LEVELS << 16) / (r_fog_distance->value_float * RCL_UNITS_PER_SQUARE));
+
+	RCL_renderSimple(camera, R_WallHeight, R_WallType, NULL, constraints);
+
+	R_DrawPlanes();
+	R_DrawSprites();
+
+	R_UpdateDynamicResolution((float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency()));
+
+	if (view8 != surface8 || camera.resolution.x != view8->w)
+		R_UpscaleView();
+
+	return 0;
+}
+
+static void R_CountHits(RCL_HitResult *hits, uint16_t hitCount, uint16_t x, RCL_Ray ray)
 {
-	Uint32 format;
+	ray_stats.hits += hitCount;
 
-	window = SDL_CreateWindow("NEUROTTIC", RENDER_WIDTH, RENDER_HEIGHT, SDL_WINDOW_RESIZABLE);
-	if (!window)
-		return -1;
+#ifdef RCL_COUNT_STEPS
+	Uint32 steps = RCL_stepCount - column_start_steps;
+	column_start_steps = RCL_stepCount;
 
-	SDL_SetWindowMinimumSize(window, RENDER_WIDTH, RENDER_HEIGHT);
+	ray_stats.steps += steps;
+	ray_stats.max_column_steps = SDL_max(ray_stats.max_column_steps, steps);
+#endif
+}
 
-	renderer = SDL_CreateRenderer(window, NULL);
-	if (!renderer)
-		return -1;
+/* cast the rays of the current view without drawing anything */
+void R_CastRays(ray_stats_t *stats)
+{
+	PROFILE_FUNCTION();
 
-	SDL_SetRenderVSync(renderer, 1);
-	SDL_SetRenderLogicalPresentation(renderer, RENDER_WIDTH, RENDER_HEIGHT, SDL_LOGICAL_PRESENTATION_LETTERBOX, SDL_SCALEMODE_NEAREST);
+	SDL_memset(&ray_stats, 0, sizeof(ray_stats));
 
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderClear(renderer);
-	SDL_RenderPresent(renderer);
+	if (map_loaded)
+	{
+		skip_blocks = !r_skip_blocks || r_skip_blocks->value_int;
 
-	surface8 = SDL_CreateSurface(RENDER_WIDTH, RENDER_HEIGHT, SDL_PIXELFORMAT_INDEX8);
-	if (!surface8)
-		return -1;
+#ifdef RCL_COUNT_STEPS
+		column_start_steps = RCL_stepCount;
+#endif
 
-	SDL_FillSurfaceRect(surface8, NULL, 0);
+		RCL_castRaysMultiHit(camera, R_WallHeight, R_WallType, R_CountHits, constraints);
+	}
 
-	format = SDL_GetWindowPixelFormat(window);
+	if (stats)
+		*stats = ray_stats;
+}
 
-	surface24 = SDL_CreateSurface(RENDER_WIDTH, RENDER_HEIGHT, format);
-	if (!surface24)
-		return -1;
+/* setup renderer state for the currently loaded map */
+int R_NewMap(void)
+{
+	PROFILE_FUNCTION();
 
-	texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, RENDER_WIDTH, RENDER_HEIGHT);
-	if (!texture)
-		return -1;
+	Uint16 *walls;
 
-	SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+	map_loaded = SDL_FALSE;
+	SDL_memset(tilemap, 0, sizeof(tilemap));
+	SDL_memset(block_masks, 0, sizeof(block_masks));
 
-	/* create font atlas */
-	font = SDL_CreateSurface(256 * 8, 8, SDL_PIXELFORMAT_INDEX8);
-	if (!font)
-		return -1;
+	if (MS_GetCurrentMap() < 0)
+		return 0;
 
-	SDL_FillSurfaceRect(font, NULL, 0);
-	SDL_SetSurfaceColorKey(font, SDL_TRUE, 0);
+	walls = MS_GetCurrentMapPlane(0);
+	if (!walls)
+		return -1;
 
-	for (int c = 0; c < 256; c++)
+	for (int y = 0; y < MAP_SIZE; y++)
 	{
-		char *bitmap = font8x8[c];
-
-		for (int y = 0; y < 8; y++)
+		for (int x = 0; x < MAP_SIZE; x++)
 		{
-			for (int x = 0; x < 8; x++)
+			Uint16 tile = walls[y * MAP_SIZE + x];
+			const char *name = DarkWar_GetWallTexture(tile);
+			size_t size;
+
+			if (!name || tile >= MAX_WALL_TEXTURES)
+				continue;
+
+			tilemap[MAP_SIZE - 1 - y][x] = (Uint8)tile;
+			block_masks[(MAP_SIZE - 1 - y) >> MAP_BLOCK_SHIFT][x >> MAP_BLOCK_SHIFT] |=
+				(Uint64)1 << ((((MAP_SIZE - 1 - y) & 7) << 3) | (x & 7));
+
+			/* cache wall texture */
+			if (!wall_textures[tile])
 			{
-				if (bitmap[y] & 1 << x)
+				Uint8 *data = LM_LoadLump(name, &size);
+
+				if (data && size < WALL_TEXTURE_SIZE * WALL_TEXTURE_SIZE)
 				{
-					size_t ofs = y * font->pitch + x + (8 * c);
-					((Uint8 *)font->pixels)[ofs] = 255;
+					LogWarning("R_NewMap(): Wall texture \"%s\" is too small (%zu bytes)", name, size);
+					SDL_free(data);
+					data = NULL;
 				}
+
+				wall_textures[tile] = data;
 			}
 		}
 	}
 
+	if (R_SpawnSprites() != 0)
+		return -1;
+
+	/* the first two tiles of the wall plane select the floor and ceiling */
+	R_LoadFlat(&floor_flat, DarkWar_GetFloorTexture(walls[0]));
+	R_LoadFlat(&ceiling_flat, DarkWar_GetCeilingTexture(walls[1]));
+
+	floor_color = R_FindColor(0x70, 0x70, 0x70);
+	ceiling_color = R_FindColor(0x38, 0x38, 0x38);
+
+	map_loaded = SDL_TRUE;
+
 	return 0;
 }
 
-/* shutdown renderer */
-void R_Quit(void)
+/*
+ * blend tables
+ */
+
+/* fnv-1a over the palette, blend table caches are only valid for the palette they were built from */
+static Uint32 R_PaletteHash(void)
 {
-	if (window) SDL_DestroyWindow(window);
-	if (renderer) SDL_DestroyRenderer(renderer);
-	if (surface8) SDL_DestroySurface(surface8);
-	if (surface24) SDL_DestroySurface(surface24);
-	if (texture) SDL_DestroyTexture(texture);
-	if (font) SDL_DestroySurface(font);
-	window = NULL;
-	renderer = NULL;
-	surface8 = NULL;
-	surface24 = NULL;
-	texture = NULL;
-	font = NULL;
+	Uint32 hash = 2166136261u;
+
+	for (int i = 0; i < ASIZE(palette_rgb); i++)
+	{
+		hash ^= palette_rgb[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
 }
 
-/* clear screen */
-void R_Clear(Uint8 color)
+static void R_BuildBlendTables(Uint8 *tables, int levels)
 {
-	SDL_FillSurfaceRect(surface8, NULL, color);
+	PROFILE_FUNCTION();
+
+	for (int level = 1; level < levels; level++)
+	{
+		Uint8 *table = tables + (level - 1) * BLEND_TABLE_SIZE;
+
+		for (int src = 0; src < 256; src++)
+		{
+			const Uint8 *s = palette_rgb + src * 3;
+
+			for (int dst = 0; dst < 256; dst++)
+			{
+				const Uint8 *d = palette_rgb + dst * 3;
+
+				table[(src << 8) | dst] = R_LookupColor(
+					(s[0] * level + d[0] * (levels - level)) / levels,
+					(s[1] * level + d[1] * (levels - level)) / levels,
+					(s[2] * level + d[2] * (levels - level)) / levels);
+			}
+		}
+	}
 }
 
-/* draw scene */
-int R_Draw(void)
+/* read blend tables cached in the preferences directory, if they match the palette and levels */
+static int R_LoadBlendTables(const char *filename, Uint8 *tables, int levels, Uint32 hash)
+{
+	SDL_IOStream *io;
+	char magic[4];
+	Uint8 version, file_levels;
+	Uint32 file_hash;
+	size_t size = (size_t)(levels - 1) * BLEND_TABLE_SIZE;
+	int ret = -1;
+
+	io = FS_OpenFile(filename, "rb", FS_PATH_PREF);
+	if (!io)
+		return -1;
+
+	if (SDL_ReadIO(io, magic, 4) == 4 && SDL_memcmp(magic, BLEND_CACHE_MAGIC, 4) == 0 &&
+		SDL_ReadU8(io, &version) && version == BLEND_CACHE_VERSION &&
+		SDL_ReadU8(io, &file_levels) && file_levels == levels &&
+		SDL_ReadU32LE(io, &file_hash) && file_hash == hash &&
+		SDL_ReadIO(io, tables, size) == size)
+	{
+		ret = 0;
+	}
+
+	SDL_CloseIO(io);
+
+	return ret;
+}
+
+static void R_SaveBlendTables(const char *filename, const Uint8 *tables, int levels, Uint32 hash)
 {
+	SDL_IOStream *io;
+	size_t size = (size_t)(levels - 1) * BLEND_TABLE_SIZE;
+
+	io = FS_OpenFile(filename, "wb", FS_PATH_PREF);
+	if (!io)
+	{
+		LogWarning("R_SaveBlendTables(): Couldn't open \"%s\" for writing", filename);
+		return;
+	}
+
+	SDL_WriteIO(io, BLEND_CACHE_MAGIC, 4);
+	SDL_WriteU8(io, BLEND_CACHE_VERSION);
+	SDL_WriteU8(io, (Uint8)levels);
+	SDL_WriteU32LE(io, hash);
+
+	if (SDL_WriteIO(io, tables, size) != size)
+		LogWarning("R_SaveBlendTables(): Failed to write \"%s\"", filename);
+
+	SDL_CloseIO(io);
+}
+
+/* make sure the blend tables match the palette and r_blend_levels, loading them from the cache or building them */
+static int R_UpdateBlendTables(void)
+{
+	int levels = SDL_clamp(r_blend_levels ? r_blend_levels->value_int : 4, 2, MAX_BLEND_LEVELS);
+	size_t size = (size_t)(levels - 1) * BLEND_TABLE_SIZE;
+	char filename[64];
+	Uint32 hash;
+	Uint8 *tables;
+
+	if (blend_tables && blend_levels == levels)
+		return 0;
+
+	tables = SDL_malloc(size);
+	if (!tables)
+		return LogError("R_UpdateBlendTables(): Memory allocation of %zu bytes failed", size);
+
+	hash = R_PaletteHash();
+	SDL_snprintf(filename, sizeof(filename), "blend_%08x_%d.dat", hash, levels);
+
+	if (R_LoadBlendTables(filename, tables, levels, hash) != 0)
+	{
+		R_BuildBlendTables(tables, levels);
+		R_SaveBlendTables(filename, tables, levels, hash);
+		Log("Built %d blend tables for palette %08x", levels - 1, hash);
+	}
+
+	if (blend_tables)
+		SDL_free(blend_tables);
+
+	blend_tables = tables;
+	blend_levels = levels;
+
 	return 0;
 }
 
@@ -141,21 +1442,293 @@ int R_DrawRect(int x, int y, int w, int h, Uint8 color)
 	return SDL_FillSurfaceRect(surface8, &rect, color);
 }
 
+/*
+ * scaled surface drawing
+ */
+
+/* free runs along with their surface */
+static void SDLCALL R_FreeSurfaceRuns(void *userdata, void *value)
+{
+	SDL_free(value);
+}
+
+/* find or build the opaque runs of a keyed surface */
+static surface_runs_t *R_CacheSurfaceRuns(SDL_Surface *surface, Uint32 key)
+{
+	SDL_PropertiesID props = SDL_GetSurfaceProperties(surface);
+	surface_runs_t *entry;
+	size_t count = 0, size;
+	Uint16 *run;
+
+	if (!props)
+		return NULL;
+
+	/* the runs live as long as the surface, but rebuild them if it was changed in place */
+	entry = SDL_GetPointerProperty(props, SURFACE_RUNS_PROPERTY, NULL);
+	if (entry && entry->key == key && entry->w == surface->w && entry->h == surface->h &&
+		entry->pitch == surface->pitch && entry->pixels == surface->pixels)
+		return entry;
+
+	/* size the runs first */
+	for (int y = 0; y < surface->h; y++)
+	{
+		const Uint8 *src = (const Uint8 *)surface->pixels + y * surface->pitch;
+
+		for (int x = 0; x < surface->w; x++)
+		{
+			if (src[x] != key && (x == 0 || src[x - 1] == key))
+				count += 2;
+		}
+
+		count++;
+	}
+
+	size = sizeof(surface_runs_t) + surface->h * sizeof(Uint32) + count * sizeof(Uint16);
+	entry = SDL_malloc(size);
+	if (!entry)
+	{
+		LogError("R_CacheSurfaceRuns(): Memory allocation of %zu bytes failed", size);
+		return NULL;
+	}
+
+	entry->key = key;
+	entry->w = surface->w;
+	entry->h = surface->h;
+	entry->pitch = surface->pitch;
+	entry->pixels = surface->pixels;
+	entry->rows = (Uint32 *)(entry + 1);
+	entry->runs = (Uint16 *)(entry->rows + surface->h);
+	run = entry->runs;
+
+	for (int y = 0; y < surface->h; y++)
+	{
+		const Uint8 *src = (const Uint8 *)surface->pixels + y * surface->pitch;
+		int x = 0;
+
+		entry->rows[y] = (Uint32)(run - entry->runs);
+
+		while (x < surface->w)
+		{
+			while (x < surface->w && src[x] == key) x++;
+
+			if (x == surface->w)
+				break;
+
+			*run++ = (Uint16)x;
+			while (x < surface->w && src[x] != key) x++;
+			*run++ = (Uint16)x;
+		}
+
+		*run++ = SURFACE_RUNS_END;
+	}
+
+	/* replacing the property frees the old runs */
+	if (SDL_SetPointerPropertyWithCleanup(props, SURFACE_RUNS_PROPERTY, entry, R_FreeSurfaceRuns, NULL) != 0)
+		return NULL;
+
+	return entry;
+}
+
+/* first column of the w wide destination that samples source column sx or later, in 16.16 steps of du */
+static inline int R_FirstColumn(int sx, Uint32 du)
+{
+	return (int)((((Uint64)sx << 16) + du - 1) / du);
+}
+
+/* copy the texels from local column x1 up to x2 of one destination row */
+static inline void R_CopyScaled(Uint8 *dst, const Uint8 *src, int x1, int x2, Uint32 du)
+{
+	Uint32 u = (Uint32)x1 * du;
+
+	for (int x = x1; x < x2; x++, u += du)
+		dst[x] = src[u >> 16];
+}
+
 /* draw surface */
 int R_DrawSurface(int x, int y, int w, int h, SDL_Surface *surface)
 {
-	const SDL_Rect rect = {x, y, w, h};
-	return SDL_SoftStretch(surface, NULL, surface8, &rect, SDL_SCALEMODE_NEAREST);
+	PROFILE_FUNCTION();
+
+	surface_runs_t *runs = NULL;
+	Uint32 key, du, dv;
+	int x1, y1, x2, y2;
+
+	/* stoopid */
+	if (!surface)
+		return LogError("R_DrawSurface(): NULL pointer passed as surface");
+
+	/* only 8-bit surfaces have a fast path */
+	if (surface->format->bytes_per_pixel != 1)
+	{
+		const SDL_Rect rect = {x, y, w, h};
+		return SDL_SoftStretch(surface, NULL, surface8, &rect, SDL_SCALEMODE_NEAREST);
+	}
+
+	if (w <= 0 || h <= 0 || surface->w <= 0 || surface->h <= 0)
+		return 0;
+
+	/* clip to the screen, in destination columns and rows relative to x,y */
+	x1 = SDL_max(-x, 0);
+	y1 = SDL_max(-y, 0);
+	x2 = SDL_min(w, surface8->w - x);
+	y2 = SDL_min(h, surface8->h - y);
+
+	if (x1 >= x2 || y1 >= y2)
+		return 0;
+
+	if (SDL_GetSurfaceColorKey(surface, &key) == 0 && !(runs = R_CacheSurfaceRuns(surface, key)))
+		return -1;
+
+	/* 16.16 source texels per destination pixel */
+	du = (Uint32)(((Uint64)surface->w << 16) / w);
+	dv = (Uint32)(((Uint64)surface->h << 16) / h);
+
+	for (int dy = y1; dy < y2; dy++)
+	{
+		int sy = (int)(((Uint64)dy * dv) >> 16);
+		const Uint8 *src = (const Uint8 *)surface->pixels + sy * surface->pitch;
+		Uint8 *dst = (Uint8 *)surface8->pixels + (y + dy) * surface8->pitch + x;
+
+		if (!runs)
+		{
+			R_CopyScaled(dst, src, x1, x2, du);
+			continue;
+		}
+
+		for (const Uint16 *run = runs->runs + runs->rows[sy]; *run != SURFACE_RUNS_END; run += 2)
+		{
+			int rx1 = SDL_max(R_FirstColumn(run[0], du), x1);
+			int rx2 = SDL_min(R_FirstColumn(run[1], du), x2);
+
+			if (rx1 < rx2)
+				R_CopyScaled(dst, src, rx1, rx2, du);
+		}
+	}
+
+	return 0;
+}
+
+/* draw 8-bit surface scaled to w x h and blended over the screen, skipping its color key */
+int R_DrawSurfaceBlended(int x, int y, int w, int h, SDL_Surface *surface, float alpha)
+{
+	const Uint8 *table;
+	Uint32 key;
+	SDL_bool keyed;
+	Uint32 du, dv;
+	int level, x1, y1, x2, y2;
+
+	/* stoopid */
+	if (!surface)
+		return LogError("R_DrawSurfaceBlended(): NULL pointer passed as surface");
+
+	if (surface->format->bytes_per_pixel != 1)
+		return LogError("R_DrawSurfaceBlended(): Surface isn't 8-bit");
+
+	if (w <= 0 || h <= 0 || surface->w <= 0 || surface->h <= 0)
+		return 0;
+
+	if (R_UpdateBlendTables() != 0)
+		return -1;
+
+	/* round to the nearest table, the ends need none */
+	level = (int)(clampf(alpha, 0, 1) * blend_levels + 0.5f);
+
+	if (level <= 0)
+		return 0;
+
+	if (level >= blend_levels)
+		return R_DrawSurface(x, y, w, h, surface);
+
+	table = blend_tables + (level - 1) * BLEND_TABLE_SIZE;
+	keyed = SDL_GetSurfaceColorKey(surface, &key) == 0;
+
+	/* 16.16 source texels per screen pixel */
+	du = (Uint32)(((Uint64)surface->w << 16) / w);
+	dv = (Uint32)(((Uint64)surface->h << 16) / h);
+
+	x1 = SDL_max(x, 0);
+	y1 = SDL_max(y, 0);
+	x2 = SDL_min(x + w, surface8->w);
+	y2 = SDL_min(y + h, surface8->h);
+
+	for (int dy = y1; dy < y2; dy++)
+	{
+		const Uint8 *src = (const Uint8 *)surface->pixels + ((Uint32)(dy - y) * dv >> 16) * surface->pitch;
+		Uint8 *dst = (Uint8 *)surface8->pixels + dy * surface8->pitch;
+		Uint32 u = (Uint32)(x1 - x) * du;
+
+		for (int dx = x1; dx < x2; dx++, u += du)
+		{
+			Uint8 texel = src[u >> 16];
+
+			if (!keyed || texel != key)
+				dst[dx] = table[(texel << 8) | dst[dx]];
+		}
+	}
+
+	return 0;
+}
+
+/* wait for the display when flipping */
+void R_SetVSync(SDL_bool enable)
+{
+	if (renderer)
+		SDL_SetRenderVSync(renderer, enable ? 1 : 0);
+}
+
+/* check if waiting for the display when flipping */
+SDL_bool R_GetVSync(void)
+{
+	int vsync = 0;
+
+	if (!renderer || SDL_GetRenderVSync(renderer, &vsync) != 0)
+		return SDL_FALSE;
+
+	return vsync != 0;
+}
+
+/* convert the screen to 32-bit through the output colors */
+static void R_ConvertScreen(Uint8 *pixels, int pitch)
+{
+	PROFILE_FUNCTION();
+
+	for (int y = 0; y < surface8->h; y++)
+	{
+		const Uint8 *src = (const Uint8 *)surface8->pixels + y * surface8->pitch;
+		Uint32 *dst = (Uint32 *)(pixels + y * pitch);
+
+		for (int x = 0; x < surface8->w; x++)
+			dst[x] = output_lut[src[x]];
+	}
 }
 
 /* flip to visible screen */
 void R_Flip(void)
 {
-	SDL_BlitSurface(surface8, NULL, surface24, NULL);
-	SDL_UpdateTexture(texture, NULL, surface24->pixels, surface24->pitch);
+	PROFILE_FUNCTION();
+
+	void *pixels;
+	int pitch;
+
+	/* convert straight into the texture, other formats go through SDL without the palette blend */
+	if (surface24->format->bytes_per_pixel == 4 && SDL_LockTexture(texture, NULL, &pixels, &pitch) == 0)
+	{
+		R_ConvertScreen(pixels, pitch);
+		SDL_UnlockTexture(texture);
+		Perf_Mark(PERF_CONVERT);
+	}
+	else
+	{
+		SDL_BlitSurface(surface8, NULL, surface24, NULL);
+		Perf_Mark(PERF_CONVERT);
+
+		SDL_UpdateTexture(texture, NULL, surface24->pixels, surface24->pitch);
+	}
+
 	SDL_RenderClear(renderer);
 	SDL_RenderTexture(renderer, texture, NULL, NULL);
 	SDL_RenderPresent(renderer);
+	Perf_Mark(PERF_PRESENT);
 }
 
 void R_SetPalette_REAL(Uint8 *palette)
@@ -170,16 +1743,84 @@ void R_SetPalette_REAL(Uint8 *palette)
 	}
 
 	SDL_SetPaletteColors(surface8->format->palette, colors, 0, 256);
+
+	/* blend tables are rebuilt or loaded for this palette when next used */
+	SDL_memcpy(palette_rgb, palette, sizeof(palette_rgb));
+	blend_levels = 0;
+
+	R_UpdateOutputLUT();
+
+	/* level 0 is the palette itself, the others fade it to black */
+	for (int i = 0; i < 256; i++)
+		shade_tables[0][i] = (Uint8)i;
+
+	for (int level = 1; level < SHADE_LEVELS; level++)
+	{
+		int k = SHADE_LEVELS - 1 - level;
+
+		for (int i = 0; i < 256; i++)
+		{
+			shade_tables[level][i] = R_LookupColor(
+				palette[i * 3] * k / (SHADE_LEVELS - 1),
+				palette[i * 3 + 1] * k / (SHADE_LEVELS - 1),
+				palette[i * 3 + 2] * k / (SHADE_LEVELS - 1));
+		}
+	}
 }
 
-void R_SetPosition(float x, float y, float z)
+void R_SetPaletteBlend(Uint8 r, Uint8 g, Uint8 b, float amount)
 {
+	int step = (int)(clampf(amount, 0, 1) * PALETTE_BLEND_STEPS + 0.5f);
+
+	/* nothing to do while it holds still */
+	if (step == palette_blend_step && (step == 0 || (r == palette_blend.r && g == palette_blend.g && b == palette_blend.b)))
+		return;
+
+	palette_blend.r = r;
+	palette_blend.g = g;
+	palette_blend.b = b;
+	palette_blend_step = step;
+
+	R_UpdateOutputLUT();
+}
 
+void R_SetPosition(float x, float y, float z)
+{
+	camera.position.x = (RCL_Unit)(x * RCL_UNITS_PER_SQUARE);
+	camera.position.y = (RCL_Unit)((MAP_SIZE - y) * RCL_UNITS_PER_SQUARE);
+	camera.height = (RCL_Unit)(z * RCL_UNITS_PER_SQUARE);
 }
 
 void R_SetAngles(float x, float y, float z)
 {
+	/* raycastlib angles rotate clockwise, one full turn per square */
+	camera.direction = (RCL_Unit)(-y * RCL_UNITS_PER_SQUARE / 360.0f);
+}
+
+void R_SetView(fixed_t x, fixed_t y, fixed_t z, angle_t angle)
+{
+	camera.position.x = FIXED_TO_RCL(x);
+	camera.position.y = FIXED_TO_RCL(INT_TO_FIXED(MAP_SIZE) - y);
+	camera.height = FIXED_TO_RCL(z);
+	camera.direction = ANGLE_TO_RCL(angle);
+}
+
+SDL_Surface *R_GetScreenSurface(void)
+{
+	return surface8;
+}
+
+int R_GetScreenHeight(void)
+{
+	return SDL_AtomicGet(&screen_height);
+}
 
+void R_GetViewSize(int *width, int *height)
+{
+	if (width)
+		*width = camera.resolution.x;
+	if (height)
+		*height = camera.resolution.y;
 }
 
 /* draw string at x,y with color */
@@ -192,11 +1833,17 @@ void R_DrawString(int x, int y, Uint8 color, const char *fmt, ...)
 	SDL_vsnprintf(buffer, sizeof(buffer), fmt, ap);
 	va_end(ap);
 
-	for (int i = 0; i < SDL_strlen(buffer); i++)
+	R_DrawText(x, y, color, buffer);
+}
+
+/* draw unformatted text at x,y with color */
+void R_DrawText(int x, int y, Uint8 color, const char *text)
+{
+	for (const char *c = text; *c; c++)
 	{
-		if (buffer[i] >= 0 && buffer[i] < 256)
+		if (*c >= 0 && *c < 256)
 		{
-			SDL_Rect srcrect = {buffer[i] * 8, 0, 8, 8};
+			SDL_Rect srcrect = {*c * 8, 0, 8, 8};
 			SDL_Rect dstrect = {x, y, 8, 8};
 			SDL_BlitSurface(font, &srcrect, surface8, &dstrect);
 			x += 8;
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "rlew.h"
+#include "profiler.h"
 
 /* compress data from SRC and write into DEST */
 /* returns the number of bytes written to DEST */
@@ -77,6 +78,8 @@ size_t rlew_compress(Uint16 *src, size_t src_len, Uint16 tag, Uint16 *dest, size
 /* returns the number of bytes written to DEST */
 size_t rlew_uncompress(Uint16 *src, size_t src_len, Uint16 tag, Uint16 *dest, size_t dest_len)
 {
+	PROFILE_FUNCTION();
+
 	size_t read, written;
 	Uint16 test, rle_len, rle_value, i;
 
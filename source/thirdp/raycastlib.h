@@ -12,6 +12,30 @@
   Before including the library define RCL_PIXEL_FUNCTION to the name of the
   function (with RCL_PixelFunction signature) that will render your pixels!
 
+  Alternatively define RCL_COLUMN_FUNCTION to the name of a function taking
+  RCL_ColumnInfo *, RCL_renderSimple will then call it once per screen column
+  with the visible wall slice instead of calling the pixel function for every
+  pixel, and leaves floors and ceilings to the caller.
+
+  Define RCL_ARRAY_FUNCTION and RCL_TYPE_FUNCTION to the names of static
+  inline array functions (defined anywhere in the including file) to have
+  them inlined into the ray marching loop. RCL_castRaysMultiHit and
+  RCL_renderSimple take the inlined path when called with exactly these
+  functions, any other functions still go through function pointers.
+
+  With those, RCL_EMPTY_BLOCK_FUNCTION may name a static inline function
+  taking block coordinates (squares shifted right by RCL_EMPTY_BLOCK_SHIFT)
+  that returns nonzero if RCL_ARRAY_FUNCTION is 0 for every square of the
+  block. Rays then cross such blocks in a single step.
+
+  Define RCL_COUNT_STEPS to count the steps taken by all rays in
+  RCL_stepCount.
+
+  Define RCL_COLUMN_TABLE_SIZE to the largest horizontal resolution to keep
+  the camera space ray direction of each column in a table, rebuilt only when
+  the resolution changes. Casting rays then only rotates them by the camera
+  angle. Wider resolutions compute the directions every frame.
+
   - All public (and most private) library identifiers start with RCL_.
   - Game field's bottom left corner is at [0,0].
   - X axis goes right in the ground plane.
@@ -75,7 +99,9 @@
 #define RCL_USE_COS_LUT 0 /**< type of look up table for cos function:
                            0: none (compute)
                            1: 64 items
-                           2: 128 items */
+                           2: 128 items
+                           3: RCL_UNITS_PER_SQUARE items, in an external
+                              table named by RCL_COS_LUT_TABLE */
 #endif
 
 #ifndef RCL_USE_DIST_APPROX
@@ -168,6 +194,7 @@
 #define RCL_nonZero(v) ((v) + ((v) == 0)) ///< To prevent zero divisions.
 #define RCL_zeroClamp(x) ((x) * ((x) >= 0))
 #define RCL_likely(cond)    __builtin_expect(!!(cond),1) 
+#define _RCL_FORCE_INLINE static inline __attribute__((always_inline))
 #define RCL_unlikely(cond)  __builtin_expect(!!(cond),0) 
 
 #define RCL_logV2D(v)\
@@ -276,7 +303,42 @@ typedef struct
                                 texture coordinates. */
 } RCL_PixelInfo;
 
+/**
+  Holds an information about a whole wall slice rendered by RCL_renderSimple,
+  for a column function (only used if RCL_COLUMN_FUNCTION is defined).
+*/
+typedef struct
+{
+  int16_t        x;         ///< On-screen column.
+  int16_t        top;       ///< First visible wall row.
+  int16_t        bottom;    /**< Last visible wall row, less than top if the
+                                 column has no wall. */
+  int16_t        wallStart; ///< Unclipped first wall row.
+  RCL_Unit       depth;     ///< Corrected depth of the wall.
+  RCL_Unit       texCoordX; /**< Normalized (0 to RCL_UNITS_PER_SQUARE - 1)
+                                 horizontal texture coordinate. */
+  RCL_Unit       texCoordY; /**< Vertical texture coordinate at the top row,
+                                 scaled by RCL_TEXTURE_INTERPOLATION_SCALE. */
+  RCL_Unit       texStepY;  /**< Vertical texture coordinate step per row,
+                                 scaled by RCL_TEXTURE_INTERPOLATION_SCALE. */
+  const RCL_HitResult *hit; ///< Corresponding ray hit.
+} RCL_ColumnInfo;
+
+#ifdef RCL_COLUMN_FUNCTION
+void RCL_COLUMN_FUNCTION (RCL_ColumnInfo *column);
+#endif
+
+#if defined(RCL_COLUMN_FUNCTION) && !defined(RCL_PIXEL_FUNCTION)
+  // column-only rendering, pixel based functions won't draw anything
+  #define RCL_PIXEL_FUNCTION _RCL_noPixelFunction
+
+static inline void _RCL_noPixelFunction(RCL_PixelInfo *pixel)
+{
+  (void)pixel;
+}
+#else
 void RCL_PIXEL_FUNCTION (RCL_PixelInfo *pixel);
+#endif
 
 typedef struct
 {
@@ -294,10 +356,31 @@ typedef struct
   very often.
 */ 
 typedef RCL_Unit (*RCL_ArrayFunction)(int16_t x, int16_t y);
-/*
-  TODO: maybe array functions should be replaced by defines of funtion names
-  like with pixelFunc? Could be more efficient than function pointers.
-*/
+
+#if defined(RCL_ARRAY_FUNCTION) != defined(RCL_TYPE_FUNCTION)
+  #error RCL_ARRAY_FUNCTION and RCL_TYPE_FUNCTION must be defined together
+#endif
+
+#ifdef RCL_ARRAY_FUNCTION
+static inline RCL_Unit RCL_ARRAY_FUNCTION (int16_t x, int16_t y);
+static inline RCL_Unit RCL_TYPE_FUNCTION (int16_t x, int16_t y);
+#endif
+
+#ifdef RCL_EMPTY_BLOCK_FUNCTION
+  #ifndef RCL_ARRAY_FUNCTION
+    #error RCL_EMPTY_BLOCK_FUNCTION needs RCL_ARRAY_FUNCTION
+  #endif
+
+  #ifndef RCL_EMPTY_BLOCK_SHIFT
+    #define RCL_EMPTY_BLOCK_SHIFT 3 ///< 8x8 square blocks
+  #endif
+
+static inline int8_t RCL_EMPTY_BLOCK_FUNCTION (int16_t blockX, int16_t blockY);
+#endif
+
+#ifdef RCL_COUNT_STEPS
+uint32_t RCL_stepCount = 0; ///< Steps taken by all rays, never reset.
+#endif
 
 /**
   Function that renders a single pixel at the display. It is handed an info
@@ -603,6 +686,8 @@ RCL_Unit RCL_cos(RCL_Unit input)
 
 #elif RCL_USE_COS_LUT == 2
   return cosLUT[input / 8];
+#elif RCL_USE_COS_LUT == 3
+  return RCL_COS_LUT_TABLE[input];
 #else
   if (input < RCL_UNITS_PER_SQUARE / 4)
     return trigHelper(input);
@@ -737,10 +822,16 @@ static inline int8_t RCL_pointIsLeftOfRay(RCL_Vector2D point, RCL_Ray ray)
          // ^ Z component of cross-product
 }
 
-void RCL_castRayMultiHit(RCL_Ray ray, RCL_ArrayFunction arrayFunc,
-  RCL_ArrayFunction typeFunc, RCL_HitResult *hitResults,
-  uint16_t *hitResultsLen, RCL_RayConstraints constraints)
+/* Body of RCL_castRayMultiHit, forced inline so that constant array functions
+   get inlined into the DDA loop. skipEmpty may only be set if arrayFunc is 0
+   exactly where RCL_ARRAY_FUNCTION is. */
+_RCL_FORCE_INLINE void _RCL_castRayMultiHit(RCL_Ray ray,
+  RCL_ArrayFunction arrayFunc, RCL_ArrayFunction typeFunc,
+  RCL_HitResult *hitResults, uint16_t *hitResultsLen,
+  RCL_RayConstraints constraints, int8_t skipEmpty)
 {
+  _RCL_UNUSED(skipEmpty)
+
   RCL_Vector2D currentPos = ray.start;
   RCL_Vector2D currentSquare;
 
@@ -803,8 +894,18 @@ void RCL_castRayMultiHit(RCL_Ray ray, RCL_ArrayFunction arrayFunc,
   RCL_Unit rayDirYRecip = RECIP_SCALE / RCL_nonZero(ray.direction.y);
   // ^ we precompute reciprocals to avoid divisions in the loop
 
+#ifdef RCL_EMPTY_BLOCK_FUNCTION
+  RCL_Vector2D lastBlock;
+  lastBlock.x = -(1 << 16); // not a block the ray can be in
+  lastBlock.y = -(1 << 16);
+#endif
+
   for (uint16_t i = 0; i < constraints.maxSteps; ++i)
   {
+#ifdef RCL_COUNT_STEPS
+    RCL_stepCount++;
+#endif
+
     RCL_Unit currentType = arrayFunc(currentSquare.x,currentSquare.y);
 
     if (RCL_unlikely(currentType != squareType))
@@ -926,6 +1027,65 @@ void RCL_castRayMultiHit(RCL_Ray ray, RCL_ArrayFunction arrayFunc,
 
     // DDA step
 
+#ifdef RCL_EMPTY_BLOCK_FUNCTION
+    RCL_Unit blockX = currentSquare.x >> RCL_EMPTY_BLOCK_SHIFT;
+    RCL_Unit blockY = currentSquare.y >> RCL_EMPTY_BLOCK_SHIFT;
+
+    // each block is only looked up once, when the ray enters it
+    if (skipEmpty && squareType == 0 &&
+      (blockX != lastBlock.x || blockY != lastBlock.y) &&
+      ((lastBlock.x = blockX), (lastBlock.y = blockY),
+        RCL_EMPTY_BLOCK_FUNCTION(blockX,blockY)))
+    {
+      /* Take all the steps to the first square outside the block at once:
+      count the sides to cross along each axis to leave the block, the
+      axis reached first is left, the other one gets the steps whose sides
+      come before it (with the same tie breaking as a single step). */
+
+      RCL_Unit blockMask = (1 << RCL_EMPTY_BLOCK_SHIFT) - 1;
+
+      RCL_Unit nX = step.x > 0 ?
+        blockMask + 1 - (currentSquare.x & blockMask) :
+        (currentSquare.x & blockMask) + 1;
+
+      RCL_Unit nY = step.y > 0 ?
+        blockMask + 1 - (currentSquare.y & blockMask) :
+        (currentSquare.y & blockMask) + 1;
+
+      RCL_Unit exitX = nextSideDist.x + (nX - 1) * delta.x;
+      RCL_Unit exitY = nextSideDist.y + (nY - 1) * delta.y;
+
+      // at most blockMask steps along the other axis, cheaper than dividing
+
+      if (exitX < exitY)
+      {
+        while (nextSideDist.y <= exitX)
+        {
+          nextSideDist.y += delta.y;
+          currentSquare.y += step.y;
+        }
+
+        currentSquare.x += step.x * nX;
+        nextSideDist.x = exitX + delta.x;
+        stepHorizontal = 1;
+      }
+      else
+      {
+        while (nextSideDist.x < exitY)
+        {
+          nextSideDist.x += delta.x;
+          currentSquare.x += step.x;
+        }
+
+        currentSquare.y += step.y * nY;
+        nextSideDist.y = exitY + delta.y;
+        stepHorizontal = 0;
+      }
+
+      continue;
+    }
+#endif
+
     if (nextSideDist.x < nextSideDist.y)
     {
       nextSideDist.x += delta.x;
@@ -941,6 +1101,14 @@ void RCL_castRayMultiHit(RCL_Ray ray, RCL_ArrayFunction arrayFunc,
   }
 }
 
+void RCL_castRayMultiHit(RCL_Ray ray, RCL_ArrayFunction arrayFunc,
+  RCL_ArrayFunction typeFunc, RCL_HitResult *hitResults,
+  uint16_t *hitResultsLen, RCL_RayConstraints constraints)
+{
+  _RCL_castRayMultiHit(ray,arrayFunc,typeFunc,hitResults,hitResultsLen,
+    constraints,0);
+}
+
 RCL_HitResult RCL_castRay(RCL_Ray ray, RCL_ArrayFunction arrayFunc)
 {
   RCL_HitResult result;
@@ -958,10 +1126,79 @@ RCL_HitResult RCL_castRay(RCL_Ray ray, RCL_ArrayFunction arrayFunc)
   return result;
 }
 
-void RCL_castRaysMultiHit(RCL_Camera cam, RCL_ArrayFunction arrayFunc,
-  RCL_ArrayFunction typeFunction, RCL_ColumnFunction columnFunc,
-  RCL_RayConstraints constraints)
+#ifdef RCL_COLUMN_TABLE_SIZE
+/* Ray direction of each column for a camera facing x+ (direction 0), one
+   square deep. */
+RCL_Vector2D _RCL_columnDirections[RCL_COLUMN_TABLE_SIZE];
+RCL_Unit _RCL_columnTableResolution = 0;
+
+static void _RCL_updateColumnTable(RCL_Unit resolution)
 {
+  if (resolution == _RCL_columnTableResolution)
+    return;
+
+  // the same interpolation as _RCL_castRaysMultiHit, for direction 0
+
+  RCL_Vector2D dir1 = RCL_angleToDirection(-RCL_HORIZONTAL_FOV_HALF);
+  RCL_Vector2D dir2 = RCL_angleToDirection(RCL_HORIZONTAL_FOV_HALF);
+
+  RCL_Unit cos = RCL_nonZero(RCL_cos(RCL_HORIZONTAL_FOV_HALF));
+
+  dir1.x = (dir1.x * RCL_UNITS_PER_SQUARE) / cos;
+  dir1.y = (dir1.y * RCL_UNITS_PER_SQUARE) / cos;
+
+  dir2.x = (dir2.x * RCL_UNITS_PER_SQUARE) / cos;
+  dir2.y = (dir2.y * RCL_UNITS_PER_SQUARE) / cos;
+
+  for (RCL_Unit i = 0; i < resolution; ++i)
+  {
+    _RCL_columnDirections[i].x = dir1.x + (i * (dir2.x - dir1.x)) / resolution;
+    _RCL_columnDirections[i].y = dir1.y + (i * (dir2.y - dir1.y)) / resolution;
+  }
+
+  _RCL_columnTableResolution = resolution;
+}
+#endif
+
+/* Body of RCL_castRaysMultiHit, hits has to hold constraints.maxHits items
+   (variable length arrays would prevent inlining). */
+_RCL_FORCE_INLINE void _RCL_castRaysMultiHit(RCL_Camera cam,
+  RCL_ArrayFunction arrayFunc, RCL_ArrayFunction typeFunction,
+  RCL_ColumnFunction columnFunc, RCL_RayConstraints constraints,
+  RCL_HitResult *hits, int8_t skipEmpty)
+{
+  uint16_t hitCount;
+
+  RCL_Ray r;
+  r.start = cam.position;
+
+#ifdef RCL_COLUMN_TABLE_SIZE
+  if (cam.resolution.x <= RCL_COLUMN_TABLE_SIZE)
+  {
+    _RCL_updateColumnTable(cam.resolution.x);
+
+    // rotate the camera space directions clockwise by the camera angle
+
+    RCL_Unit sin = RCL_sin(cam.direction);
+    RCL_Unit cos = RCL_cos(cam.direction);
+
+    for (int16_t i = 0; i < cam.resolution.x; ++i)
+    {
+      RCL_Vector2D d = _RCL_columnDirections[i];
+
+      r.direction.x = (d.x * cos + d.y * sin) / RCL_UNITS_PER_SQUARE;
+      r.direction.y = (d.y * cos - d.x * sin) / RCL_UNITS_PER_SQUARE;
+
+      _RCL_castRayMultiHit(r,arrayFunc,typeFunction,hits,&hitCount,
+        constraints,skipEmpty);
+
+      columnFunc(hits,hitCount,i,r);
+    }
+
+    return;
+  }
+#endif
+
   RCL_Vector2D dir1 =
     RCL_angleToDirection(cam.direction - RCL_HORIZONTAL_FOV_HALF);
 
@@ -982,12 +1219,6 @@ void RCL_castRaysMultiHit(RCL_Camera cam, RCL_ArrayFunction arrayFunc,
   RCL_Unit dX = dir2.x - dir1.x;
   RCL_Unit dY = dir2.y - dir1.y;
 
-  RCL_HitResult hits[constraints.maxHits];
-  uint16_t hitCount;
-
-  RCL_Ray r;
-  r.start = cam.position;
-
   RCL_Unit currentDX = 0;
   RCL_Unit currentDY = 0;
 
@@ -1000,7 +1231,8 @@ void RCL_castRaysMultiHit(RCL_Camera cam, RCL_ArrayFunction arrayFunc,
     r.direction.x = dir1.x + currentDX / cam.resolution.x;
     r.direction.y = dir1.y + currentDY / cam.resolution.x;
 
-    RCL_castRayMultiHit(r,arrayFunc,typeFunction,hits,&hitCount,constraints);
+    _RCL_castRayMultiHit(r,arrayFunc,typeFunction,hits,&hitCount,constraints,
+      skipEmpty);
 
     columnFunc(hits,hitCount,i,r);
 
@@ -1009,6 +1241,25 @@ void RCL_castRaysMultiHit(RCL_Camera cam, RCL_ArrayFunction arrayFunc,
   }
 }
 
+void RCL_castRaysMultiHit(RCL_Camera cam, RCL_ArrayFunction arrayFunc,
+  RCL_ArrayFunction typeFunction, RCL_ColumnFunction columnFunc,
+  RCL_RayConstraints constraints)
+{
+  RCL_HitResult hits[constraints.maxHits];
+
+#ifdef RCL_ARRAY_FUNCTION
+  if (arrayFunc == RCL_ARRAY_FUNCTION && typeFunction == RCL_TYPE_FUNCTION)
+  {
+    _RCL_castRaysMultiHit(cam,RCL_ARRAY_FUNCTION,RCL_TYPE_FUNCTION,
+      columnFunc,constraints,hits,1);
+    return;
+  }
+#endif
+
+  _RCL_castRaysMultiHit(cam,arrayFunc,typeFunction,columnFunc,constraints,
+    hits,0);
+}
+
 /**
   Helper function that determines intersection with both ceiling and floor.
 */
@@ -1035,6 +1286,15 @@ RCL_Unit _floorHeightNotZeroFunction(int16_t x, int16_t y)
     // ^ this makes collisions between all squares - needed for rolling doors
 }
 
+#ifdef RCL_ARRAY_FUNCTION
+/// Same as _floorHeightNotZeroFunction, for the inlined array function.
+static inline RCL_Unit _RCL_inlineFloorHeightNotZero(int16_t x, int16_t y)
+{
+  return RCL_ARRAY_FUNCTION(x,y) == 0 ? 0 :
+    RCL_nonZero((x & 0x00FF) | ((y & 0x00FF) << 8));
+}
+#endif
+
 RCL_Unit RCL_adjustDistance(RCL_Unit distance, RCL_Camera *camera,
   RCL_Ray *ray)
 {
@@ -1506,6 +1766,52 @@ void _RCL_columnFunctionSimple(RCL_HitResult *hits, uint16_t hitCount,
     _RCL_makeInfiniteHit(&p.hit,&ray);
   }
 
+#ifdef RCL_COLUMN_FUNCTION
+  {
+    RCL_ColumnInfo c;
+
+    c.x = x;
+    c.wallStart = wallStart;
+    c.depth = dist;
+    c.hit = &p.hit;
+
+    if (wallHeightScreen > 0)
+    {
+      c.top = RCL_clamp(wallStart,0,_RCL_camResYLimit);
+      c.bottom = RCL_clamp(wallStart + wallHeightScreen - 1,-1,
+        _RCL_camResYLimit);
+    }
+    else
+    {
+      // no wall, floor and ceiling meet at the horizon
+      c.top = _RCL_middleRow;
+      c.bottom = _RCL_middleRow - 1;
+    }
+
+    c.texCoordX = p.hit.textureCoord;
+
+#if RCL_ROLL_TEXTURE_COORDS == 1 && RCL_COMPUTE_WALL_TEXCOORDS == 1
+    c.texCoordX -= p.hit.doorRoll;
+#endif
+
+    // stretch the texture over exactly the rows of the wall
+    RCL_Unit wallLength = RCL_nonZero(wallHeightScreen);
+
+    c.texStepY =
+#if RCL_TEXTURE_VERTICAL_STRETCH == 1
+      (RCL_UNITS_PER_SQUARE * RCL_TEXTURE_INTERPOLATION_SCALE) / wallLength;
+#else
+      (RCL_abs(p.hit.arrayValue) * RCL_TEXTURE_INTERPOLATION_SCALE) /
+        wallLength;
+#endif
+
+    c.texCoordY = RCL_zeroClamp((c.top - wallStart) * c.texStepY);
+
+    RCL_COLUMN_FUNCTION(&c);
+    return;
+  }
+#endif
+
   // draw ceiling
 
   p.isWall = 0;
@@ -1631,6 +1937,16 @@ void RCL_renderSimple(RCL_Camera cam, RCL_ArrayFunction floorHeightFunc,
   _RCL_floorPixelDistances = floorPixelDistances; // pass to column function
 #endif
 
+#ifdef RCL_ARRAY_FUNCTION
+  if (floorHeightFunc == RCL_ARRAY_FUNCTION && typeFunc == RCL_TYPE_FUNCTION)
+  {
+    RCL_HitResult hits[constraints.maxHits];
+
+    _RCL_castRaysMultiHit(cam,_RCL_inlineFloorHeightNotZero,
+      RCL_TYPE_FUNCTION,_RCL_columnFunctionSimple,constraints,hits,1);
+  }
+  else
+#endif
   RCL_castRaysMultiHit(cam,_floorHeightNotZeroFunction,typeFunc,
     _RCL_columnFunctionSimple, constraints);
 
@@ -0,0 +1,48 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "neurottic.h"
+
+#ifdef NEUROTTIC_TRIG_LUT
+
+float trig_sin_table[TRIG_TABLE_SIZE + TRIG_TABLE_SIZE / 4 + 1];
+Sint32 trig_rcl_cos[TRIG_RCL_TABLE_SIZE];
+
+void Trig_Init(void)
+{
+	for (int i = 0; i < ASIZE(trig_sin_table); i++)
+		trig_sin_table[i] = (float)SDL_sin(i * (2.0 * M_PI / TRIG_TABLE_SIZE));
+
+	for (int i = 0; i < TRIG_RCL_TABLE_SIZE; i++)
+		trig_rcl_cos[i] = (Sint32)SDL_lround(SDL_cos(i * (2.0 * M_PI / TRIG_RCL_TABLE_SIZE)) * 1024.0);
+}
+
+#else
+
+void Trig_Init(void)
+{
+
+}
+
+#endif /* NEUROTTIC_TRIG_LUT */
@@ -0,0 +1,119 @@
+/*
+MIT License
+
+Copyright (c) 2024 erysdren (it/she/they)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#ifndef _TRIG_H_
+#define _TRIG_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <SDL3/SDL.h>
+
+/*
+ * float trigonometry for the renderer and camera, in radians
+ *
+ * built with NEUROTTIC_TRIG_LUT these read linearly interpolated tables
+ * filled in by Trig_Init(), otherwise they call libm. the game simulation
+ * doesn't use these, it has its own fixed point tables in fixed.h.
+ */
+
+#define TRIG_TABLE_BITS (12)
+#define TRIG_TABLE_SIZE (1 << TRIG_TABLE_BITS)
+#define TRIG_TABLE_MASK (TRIG_TABLE_SIZE - 1)
+
+/* raycastlib cos table, one entry per raycastlib angle unit */
+#define TRIG_RCL_TABLE_SIZE (1024)
+
+/* fill in tables */
+void Trig_Init(void);
+
+#ifdef NEUROTTIC_TRIG_LUT
+
+/* one turn of sine, plus a quarter turn for cosine and one for interpolation */
+extern float trig_sin_table[TRIG_TABLE_SIZE + TRIG_TABLE_SIZE / 4 + 1];
+
+/* cos scaled to 1024, in raycastlib units */
+extern Sint32 trig_rcl_cos[TRIG_RCL_TABLE_SIZE];
+
+/* table position of x, with 16 fractional bits */
+static inline Sint64 Trig_Index(float x)
+{
+	return (Sint64)(x * (float)(TRIG_TABLE_SIZE * 65536.0 / (2.0 * M_PI)));
+}
+
+static inline float Trig_Lookup(Sint64 index, int offset)
+{
+	const float *t = trig_sin_table + ((index >> 16) & TRIG_TABLE_MASK) + offset;
+	return t[0] + (t[1] - t[0]) * (float)(index & 0xFFFF) * (1.0f / 65536.0f);
+}
+
+static inline float Trig_Sin(float x)
+{
+	return Trig_Lookup(Trig_Index(x), 0);
+}
+
+static inline float Trig_Cos(float x)
+{
+	return Trig_Lookup(Trig_Index(x), TRIG_TABLE_SIZE / 4);
+}
+
+static inline void Trig_SinCos(float x, float *s, float *c)
+{
+	Sint64 index = Trig_Index(x);
+	*s = Trig_Lookup(index, 0);
+	*c = Trig_Lookup(index, TRIG_TABLE_SIZE / 4);
+}
+
+#else
+
+static inline float Trig_Sin(float x)
+{
+	return SDL_sinf(x);
+}
+
+static inline float Trig_Cos(float x)
+{
+	return SDL_cosf(x);
+}
+
+static inline void Trig_SinCos(float x, float *s, float *c)
+{
+	*s = SDL_sinf(x);
+	*c = SDL_cosf(x);
+}
+
+#endif /* NEUROTTIC_TRIG_LUT */
+
+static inline float Trig_Tan(float x)
+{
+	float s, c;
+	Trig_SinCos(x, &s, &c);
+	return s / c;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _TRIG_H_ */